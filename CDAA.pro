@@ -2,44 +2,62 @@ QT       += core gui sql
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
-CONFIG += c++11 static
+CONFIG += c++17 static
 
 # You can make your code fail to compile if it uses deprecated APIs.
 # In order to do so, uncomment the following line.
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
 SOURCES += \
+    connectionpool.cpp \
     contact.cpp \
     contacts.cpp \
     date.cpp \
+    dateindex.cpp \
+    dbexecutor.cpp \
     dbinterface.cpp \
     historydialog.cpp \
     interaction.cpp \
+    interactioncolumns.cpp \
     interactions.cpp \
     jsonmanager.cpp \
     main.cpp \
     mainwindow.cpp \
+    operationjournal.cpp \
     editcontactdialog.cpp \
+    storageprofile.cpp \
     todo.cpp \
+    timezone.cpp \
     tododialog.cpp \
     todos.cpp \
+    trigramindex.cpp \
     utils.cpp
 
 HEADERS += \
+    connectionpool.h \
     contact.h \
     contacts.h \
     date.h \
+    dateindex.h \
+    dbexecutor.h \
     dbinterface.h \
+    entitystore.h \
     historydialog.h \
     interaction.h \
+    interactioncolumns.h \
     interactions.h \
     jsonmanager.h \
     mainwindow.h \
+    operationjournal.h \
     editcontactdialog.h \
+    storageprofile.h \
+    timezone.h \
     todo.h \
     tododialog.h \
     todos.h \
-    utils.h
+    trigramindex.h \
+    utils.h \
+    view.h
 
 FORMS += \
     editcontactdialog.ui \
@@ -19,9 +19,12 @@ CREATE TABLE "contact" (
   "email" TEXT,
   "phone" TEXT,
   "creation_date" TEXT NOT NULL,
-  "note" TEXT
+  "note" TEXT,
+  "creation_epoch" INTEGER
 );
 
+CREATE INDEX "contact_creation" ON "contact" ("creation_epoch");
+
 -- ----------------------------
 -- Auto increment value for contact
 -- ----------------------------
@@ -38,9 +41,15 @@ CREATE TABLE "interaction" (
   "type" INTEGER NOT NULL,
   "description" TEXT,
   "date" TEXT NOT NULL,
+  "urgent" INTEGER NOT NULL DEFAULT 0,
+  "date_epoch" INTEGER,
   CONSTRAINT "owner_interaction" FOREIGN KEY ("owner_id") REFERENCES "contact" ("id") ON DELETE NO ACTION ON UPDATE NO ACTION
 );
 
+CREATE INDEX "interaction_urgent" ON "interaction" ("owner_id") WHERE "urgent" = 1;
+CREATE INDEX "interaction_owner_date" ON "interaction" ("owner_id", "date_epoch");
+CREATE INDEX "interaction_date" ON "interaction" ("date_epoch");
+
 -- ----------------------------
 -- Auto increment value for interaction
 -- ----------------------------
@@ -56,13 +65,24 @@ CREATE TABLE "todo" (
   "owner_id" INTEGER NOT NULL,
   "description" TEXT NOT NULL,
   "date" TEXT NOT NULL,
+  "urgent" INTEGER NOT NULL DEFAULT 0,
+  "date_epoch" INTEGER,
   CONSTRAINT "Owner_todo" FOREIGN KEY ("owner_id") REFERENCES "contact" ("id") ON DELETE NO ACTION ON UPDATE NO ACTION
 );
 
+CREATE INDEX "todo_urgent" ON "todo" ("owner_id") WHERE "urgent" = 1;
+CREATE INDEX "todo_owner_date" ON "todo" ("owner_id", "date_epoch");
+CREATE INDEX "todo_date" ON "todo" ("date_epoch");
+
 -- ----------------------------
 -- Auto increment value for todo
 -- ----------------------------
 UPDATE "sqlite_sequence" SET seq = 0 WHERE name = 'todo';
 
 
+-- ----------------------------
+-- Schema version (see DBInterface::migrate)
+-- ----------------------------
+PRAGMA user_version = 3;
+
 PRAGMA foreign_keys = true;
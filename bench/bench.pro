@@ -0,0 +1,9 @@
+# Benchmarks (hors de l'application), voir README.md
+# Chaque sous-projet est un exécutable indépendant qui compile les sources de l'application dont il a besoin.
+
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    datealloc \
+    interactionfilter \
+    storageprofiles
@@ -0,0 +1,12 @@
+# Mesure des allocations du formatage des dates (Date::write...), sans Qt
+
+TEMPLATE = app
+CONFIG += console c++17
+CONFIG -= qt app_bundle
+
+INCLUDEPATH += ../..
+
+SOURCES += \
+    main.cpp \
+    ../../date.cpp \
+    ../../timezone.cpp
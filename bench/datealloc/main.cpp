@@ -0,0 +1,148 @@
+/**
+ * @file main.cpp
+ *
+ * @brief Benchmark du formatage des dates : allocations sur le tas et temps par date formatée
+ *
+ * @version 1.0
+ *
+ * @author LEESTMANS Richard
+ * @author COUDERT Nicolas
+ */
+
+#include "date.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+static std::size_t allocations = 0; /*!< Nombre d'allocations sur le tas depuis le début du programme */
+
+/**
+ * Allocation comptée (remplace l'opérateur global)
+ * @param size Taille demandée
+ * @return Mémoire allouée
+ */
+void* operator new(std::size_t size)
+{
+    allocations++;
+    if(void* memory = std::malloc(size ? size : 1))
+        return memory;
+    throw std::bad_alloc();
+}
+
+/**
+ * Allocation d'un tableau comptée (remplace l'opérateur global)
+ * @param size Taille demandée
+ * @return Mémoire allouée
+ */
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+/**
+ * Libération (remplace l'opérateur global)
+ * @param memory Mémoire à libérer
+ */
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+/**
+ * Libération d'un tableau (remplace l'opérateur global)
+ * @param memory Mémoire à libérer
+ */
+void operator delete[](void* memory) noexcept
+{
+    std::free(memory);
+}
+
+/**
+ * Libération avec taille (remplace l'opérateur global)
+ * @param memory Mémoire à libérer
+ */
+void operator delete(void* memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+/**
+ * Libération d'un tableau avec taille (remplace l'opérateur global)
+ * @param memory Mémoire à libérer
+ */
+void operator delete[](void* memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+static volatile std::size_t sink = 0; /*!< Empêche le compilateur de supprimer le formatage */
+
+/**
+ * Formate toutes les dates avec un formateur et affiche les allocations et le temps par date
+ * @param name Nom du formateur
+ * @param dates Dates à formater
+ * @param format Formateur (renvoie la taille écrite)
+ * @return Nombre d'allocations pendant le formatage
+ */
+template<typename Format>
+static std::size_t measure(const char* name, const std::vector<Date>& dates, Format format)
+{
+    const std::size_t before = allocations;
+    const auto start = std::chrono::steady_clock::now();
+    std::size_t written = 0;
+    for(const Date& d : dates)
+        written += format(d);
+    const auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start);
+    const std::size_t count = allocations - before;
+    sink = sink + written;
+
+    std::printf("%-24s %12zu %14.3f %10.1f\n", name, count, static_cast<double>(count) / dates.size(),
+                elapsed.count() / dates.size());
+    return count;
+}
+
+/**
+ * Formate un million de dates avec chaque méthode de Date.
+ * Les formateurs write...() et les noms (jour, mois) ne doivent faire aucune allocation : le programme se termine
+ * avec le code 1 sinon. Les versions std::string sont mesurées pour comparaison (sans allocation tant que le texte
+ * tient dans la chaîne courte de la bibliothèque standard).
+ * @return 0 si les formateurs sans allocation n'ont rien alloué, 1 sinon
+ */
+int main()
+{
+    constexpr std::size_t COUNT = 1000000;
+    std::vector<Date> dates;
+    dates.reserve(COUNT);
+    const std::int64_t first = Date::fromCivil(1950, 1, 1).getEpoch();
+    for(std::size_t i = 0; i < COUNT; i++)
+        dates.push_back(Date::fromEpoch(first + static_cast<std::int64_t>(i) * 3541)); // About 112 years
+    (void)Date().getSqlFormat(); // Time zone table built before measuring
+
+    char buffer[Date::DATE_STRING_MAX_SIZE];
+    std::size_t allocated = 0;
+    std::printf("%-24s %12s %14s %10s\n", "formateur", "allocations", "allocs/date", "ns/date");
+    allocated += measure("writeSqlFormat", dates, [&buffer](const Date& d) {
+        return static_cast<std::size_t>(d.writeSqlFormat(buffer) - buffer);
+    });
+    allocated += measure("writeDateCompactString", dates, [&buffer](const Date& d) {
+        return static_cast<std::size_t>(d.writeDateCompactString(buffer) - buffer);
+    });
+    allocated += measure("writeDateString", dates, [&buffer](const Date& d) {
+        return static_cast<std::size_t>(d.writeDateString(buffer) - buffer);
+    });
+    allocated += measure("getDayString", dates, [](const Date& d) { return d.getDayString().size(); });
+    allocated += measure("getMonthString", dates, [](const Date& d) { return d.getMonthString().size(); });
+
+    measure("getSqlFormat", dates, [](const Date& d) { return d.getSqlFormat().size(); });
+    measure("getDateCompactString", dates, [](const Date& d) { return d.getDateCompactString().size(); });
+    measure("getDateString", dates, [](const Date& d) { return d.getDateString().size(); });
+
+    if(allocated != 0)
+    {
+        std::printf("ÉCHEC : %zu allocations dans les formateurs sans allocation\n", allocated);
+        return 1;
+    }
+    return 0;
+}
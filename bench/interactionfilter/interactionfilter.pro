@@ -0,0 +1,14 @@
+# Filtre des colonnes d'interactions (InteractionColumns::select) sur 10 millions de lignes, sans Qt
+
+TEMPLATE = app
+CONFIG += console c++17
+CONFIG -= qt app_bundle
+
+INCLUDEPATH += ../..
+
+SOURCES += \
+    main.cpp \
+    ../../interactioncolumns.cpp \
+    ../../interaction.cpp \
+    ../../date.cpp \
+    ../../timezone.cpp
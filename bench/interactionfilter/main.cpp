@@ -0,0 +1,117 @@
+/**
+ * @file main.cpp
+ *
+ * @brief Benchmark des filtres des colonnes d'interactions : temps par ligne de chaque jeu d'instructions
+ *
+ * @version 1.0
+ *
+ * @author LEESTMANS Richard
+ * @author COUDERT Nicolas
+ */
+
+#include "interactioncolumns.h"
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+/**
+ * Nom d'un jeu d'instructions
+ * @param path Jeu d'instructions
+ * @return Nom affiché
+ */
+static const char* pathName(InteractionColumns::Path path)
+{
+    switch(path)
+    {
+    case InteractionColumns::AVX2_PATH:
+        return "avx2";
+    case InteractionColumns::SSE42_PATH:
+        return "sse4.2";
+    default:
+        return "scalaire";
+    }
+}
+
+/**
+ * Évalue un filtre avec chaque jeu d'instructions disponible, affiche le temps par ligne et compare les lignes
+ * sélectionnées à celles de la boucle scalaire
+ * @param name Nom du filtre
+ * @param columns Colonnes à filtrer
+ * @param filter Filtre à évaluer
+ * @return Si tous les jeux d'instructions ont sélectionné les mêmes lignes
+ */
+static bool measure(const char* name, const InteractionColumns& columns, const InteractionColumns::Filter& filter)
+{
+    constexpr int ROUNDS = 5;
+    std::vector<std::uint32_t> reference;
+    bool same = true;
+    for(InteractionColumns::Path path : {InteractionColumns::SCALAR_PATH, InteractionColumns::SSE42_PATH,
+                                         InteractionColumns::AVX2_PATH})
+    {
+        if(path > InteractionColumns::bestPath())
+            continue; // Not supported by this processor
+
+        std::vector<std::uint32_t> selection; // Reused by every round, as in HistoryDialog
+        double best = 0;
+        for(int round = 0; round < ROUNDS; round++)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            columns.select(filter, selection, path);
+            const double elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+            if(round == 0 || elapsed < best)
+                best = elapsed;
+        }
+
+        if(path == InteractionColumns::SCALAR_PATH)
+            reference = selection;
+        else if(selection != reference)
+            same = false;
+        std::printf("%-12s %-10s %12zu %10.3f %10.1f\n", name, pathName(path), selection.size(),
+                    best / columns.size(), best / 1e6);
+    }
+    return same;
+}
+
+/**
+ * Filtre dix millions d'interactions (types et dates répartis uniformément sur 30 ans) par type, par intervalle de
+ * dates et par les deux, avec la boucle scalaire puis chaque jeu d'instructions SIMD disponible sur le processeur.
+ * @return 0 si tous les jeux d'instructions sélectionnent les mêmes lignes que la boucle scalaire, 1 sinon
+ */
+int main()
+{
+    constexpr std::size_t COUNT = 10000000;
+    const std::int64_t first = Date::fromCivil(1995, 1, 1).getEpoch();
+    const std::int64_t step = 97; // About 30 years
+
+    InteractionColumns columns;
+    columns.reserve(COUNT);
+    std::string description = "rdv"; // Not read by the filters
+    for(std::size_t i = 0; i < COUNT; i++)
+    {
+        Date date = Date::fromEpoch(first + static_cast<std::int64_t>(i) * step);
+        Interaction interaction(static_cast<int>(i % 1000), static_cast<unsigned int>(i * 7 % MAX_NUM), description, date);
+        interaction.setId(static_cast<int>(i));
+        columns.append(interaction);
+    }
+
+    InteractionColumns::Filter byType;
+    byType.type = EDIT_CONTACT;
+    InteractionColumns::Filter byDate;
+    byDate.from = Date::fromCivil(2005, 1, 1).getEpoch();
+    byDate.to = Date::fromCivil(2010, 12, 31).getEpoch();
+    InteractionColumns::Filter both = byDate;
+    both.type = REMOVE_CONTACT;
+
+    std::printf("%zu lignes, meilleur jeu d'instructions : %s\n", columns.size(), pathName(InteractionColumns::bestPath()));
+    std::printf("%-12s %-10s %12s %10s %10s\n", "filtre", "chemin", "lignes", "ns/ligne", "ms");
+    bool same = measure("type", columns, byType);
+    same = measure("dates", columns, byDate) && same;
+    same = measure("type+dates", columns, both) && same;
+
+    if(!same)
+    {
+        std::printf("ÉCHEC : les lignes sélectionnées diffèrent de la boucle scalaire\n");
+        return 1;
+    }
+    return 0;
+}
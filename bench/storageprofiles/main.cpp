@@ -0,0 +1,210 @@
+/**
+ * @file main.cpp
+ *
+ * @brief Benchmark des profils de stockage : débit des insertions, des modifications et du chargement par DBInterface
+ *
+ * @version 1.0
+ *
+ * @author LEESTMANS Richard
+ * @author COUDERT Nicolas
+ */
+
+#include "dbinterface.h"
+#include <QApplication>
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+static constexpr int CONTACTS = 1000; /*!< Contacts ajoutés */
+static constexpr int INTERACTIONS_PER_CONTACT = 10; /*!< Interactions ajoutées par contact */
+static constexpr int TODOS_PER_CONTACT = 5; /*!< Tâches ajoutées par contact */
+
+/**
+ * Crée une base de données vide à partir de Structure.sql
+ * @param path Chemin de la base de données
+ * @return Si la structure a été créée
+ */
+static bool createDatabase(const QString& path)
+{
+    QFile file(STRUCTURE_SQL);
+    if(!file.open(QIODevice::ReadOnly | QIODevice::Text))
+    {
+        std::printf("Structure introuvable : %s\n", STRUCTURE_SQL);
+        return false;
+    }
+    const QString structure = QString::fromUtf8(file.readAll());
+
+    bool created = true;
+    {
+        QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", "bench_structure");
+        db.setDatabaseName(path);
+        if(!db.open())
+            return false;
+        QSqlQuery query(db);
+        for(const QString& statement : structure.split(';'))
+            if(!statement.trimmed().isEmpty() && !query.exec(statement))
+            {
+                std::printf("Structure : %s\n", query.lastError().text().toStdString().c_str());
+                created = false;
+            }
+        db.close();
+    }
+    QSqlDatabase::removeDatabase("bench_structure");
+    return created;
+}
+
+/**
+ * Ouvre la base de données avec un profil et charge les contacts
+ * @param path Chemin de la base de données
+ * @param profile Profil de stockage
+ * @return Interface ouverte
+ */
+static std::unique_ptr<DBInterface> openDatabase(const QString& path, const StorageProfile& profile)
+{
+    auto db = std::make_unique<DBInterface>(path.toStdString(), profile);
+    db->open();
+    db->loadData();
+    return db;
+}
+
+/**
+ * Ferme une interface (les écritures en attente sont terminées) et libère sa connexion principale
+ * @param db Interface à fermer
+ */
+static void closeDatabase(std::unique_ptr<DBInterface>& db)
+{
+    db.reset();
+    QSqlDatabase::removeDatabase(QSqlDatabase::defaultConnection);
+}
+
+/**
+ * Mesure le temps écoulé depuis un instant
+ * @param timer Chronomètre démarré
+ * @return Secondes écoulées
+ */
+static double seconds(const QElapsedTimer& timer)
+{
+    return static_cast<double>(timer.nsecsElapsed()) / 1e9;
+}
+
+/**
+ * Mesure un profil sur une nouvelle base de données :
+ *      * insertion : CONTACTS contacts avec leurs interactions et leurs tâches, un flush par contact (une transaction
+ *        par action de l'utilisateur, le pire cas pour la synchronisation) ;
+ *      * modification : chaque interaction et chaque tâche, un flush par contact ;
+ *      * chargement : réouverture, contacts puis toutes les tables en cache (whenResident).
+ * Chaque phase attend la fin des écritures du thread d'écriture.
+ * @param name Nom du profil (voir StorageProfile::named)
+ * @param directory Dossier des bases de données
+ * @return Si la base de données a pu être créée
+ */
+static bool measure(const QString& name, const QTemporaryDir& directory)
+{
+    const QString path = directory.filePath(name + ".db");
+    if(!createDatabase(path))
+        return false;
+    const StorageProfile profile = StorageProfile::named(name);
+    const double rows = CONTACTS * (1 + INTERACTIONS_PER_CONTACT + TODOS_PER_CONTACT);
+
+    std::unique_ptr<DBInterface> db = openDatabase(path, profile);
+    std::vector<Interaction> interactions;
+    std::vector<Todo> todos;
+    std::string description = "Rendez-vous de suivi";
+
+    // Insert
+    QElapsedTimer timer;
+    timer.start();
+    for(int c = 0; c < CONTACTS; c++)
+    {
+        Contact contact("Prénom" + std::to_string(c), "Nom" + std::to_string(c));
+        contact.setCompany("Entreprise");
+        contact.setEmail("contact@example.com");
+        contact.setPhone("0600000000");
+        const int owner = db->add(contact);
+        for(int i = 0; i < INTERACTIONS_PER_CONTACT; i++)
+        {
+            Date date = Date::fromCivil(2020 + i % 3, 1 + static_cast<unsigned int>(i % 12), 1 + static_cast<unsigned int>(i));
+            Interaction interaction(owner, EDIT_CONTACT, description, date);
+            db->add(interaction);
+            interactions.push_back(interaction);
+        }
+        for(int t = 0; t < TODOS_PER_CONTACT; t++)
+        {
+            Date date = Date::fromCivil(2024, 1 + static_cast<unsigned int>(t), 10 + static_cast<unsigned int>(t));
+            Todo todo(owner, description, date);
+            db->add(todo);
+            todos.push_back(todo);
+        }
+        db->flush();
+    }
+    db->flush().written.wait();
+    const double insert = seconds(timer);
+
+    // Update
+    std::string updated = "Rendez-vous reporté";
+    timer.restart();
+    for(int c = 0; c < CONTACTS; c++)
+    {
+        for(int i = 0; i < INTERACTIONS_PER_CONTACT; i++)
+        {
+            Interaction& interaction = interactions[static_cast<std::size_t>(c * INTERACTIONS_PER_CONTACT + i)];
+            interaction.setDescription(updated);
+            db->update(interaction);
+        }
+        for(int t = 0; t < TODOS_PER_CONTACT; t++)
+        {
+            Todo& todo = todos[static_cast<std::size_t>(c * TODOS_PER_CONTACT + t)];
+            todo.setDescription(updated);
+            db->update(todo);
+        }
+        db->flush();
+    }
+    db->flush().written.wait();
+    const double update = seconds(timer);
+    closeDatabase(db);
+
+    // Load
+    timer.restart();
+    db = openDatabase(path, profile);
+    bool resident = false;
+    db->whenResident([&resident]() { resident = true; });
+    while(!resident)
+        QCoreApplication::processEvents();
+    const double load = seconds(timer);
+    const std::size_t loaded = db->getContacts().size() + db->getInteractions().size() + db->getTodos().size();
+    closeDatabase(db);
+
+    std::printf("%-10s %-8s %-8s %14.0f %14.0f %14.0f %10zu\n", name.toStdString().c_str(),
+                profile.getJournalMode().toStdString().c_str(), profile.getSynchronous().toStdString().c_str(),
+                rows / insert, (rows - CONTACTS) / update, static_cast<double>(loaded) / load, loaded);
+    return true;
+}
+
+/**
+ * Compare les profils de stockage "safe", "balanced" et "fast" (voir StorageProfile) sur la même charge : chaque
+ * profil utilise sa propre base de données, créée dans un dossier temporaire à partir de Structure.sql.
+ * Sans affichage, lancer avec -platform offscreen.
+ * @param argc Nombre d'arguments
+ * @param argv Arguments (ceux de Qt)
+ * @return 0 si toutes les mesures ont été faites, 1 sinon
+ */
+int main(int argc, char* argv[])
+{
+    QApplication app(argc, argv); // DBInterface reports critical errors in a message box
+
+    QTemporaryDir directory;
+    if(!directory.isValid())
+        return 1;
+
+    std::printf("%d contacts, %d interactions et %d tâches par contact\n", CONTACTS, INTERACTIONS_PER_CONTACT,
+                TODOS_PER_CONTACT);
+    std::printf("%-10s %-8s %-8s %14s %14s %14s %10s\n", "profil", "journal", "sync", "insertions/s",
+                "modifs/s", "chargement/s", "lignes");
+    for(const char* name : {"safe", "balanced", "fast"})
+        if(!measure(name, directory))
+            return 1;
+    return 0;
+}
@@ -0,0 +1,28 @@
+# Débit des insertions, des modifications et du chargement avec chaque profil de stockage (DBInterface, SQLite)
+
+TEMPLATE = app
+QT += core gui sql widgets
+CONFIG += console c++17
+CONFIG -= app_bundle
+
+INCLUDEPATH += ../..
+DEFINES += STRUCTURE_SQL=\\\"$$PWD/../../Structure.sql\\\"
+
+SOURCES += \
+    main.cpp \
+    ../../connectionpool.cpp \
+    ../../contact.cpp \
+    ../../contacts.cpp \
+    ../../date.cpp \
+    ../../dateindex.cpp \
+    ../../dbexecutor.cpp \
+    ../../dbinterface.cpp \
+    ../../interaction.cpp \
+    ../../interactions.cpp \
+    ../../operationjournal.cpp \
+    ../../storageprofile.cpp \
+    ../../timezone.cpp \
+    ../../todo.cpp \
+    ../../todos.cpp \
+    ../../trigramindex.cpp \
+    ../../utils.cpp
@@ -0,0 +1,138 @@
+/**
+ * @file connectionpool.cpp
+ *
+ * @brief Définition de la classe ConnectionPool (connexions de lecture, une par thread)
+ *
+ * @version 1.0
+ *
+ * @author LEESTMANS Richard
+ * @author COUDERT Nicolas
+ */
+
+#include "connectionpool.h"
+#include <algorithm>
+#include <functional>
+#include <thread>
+#include <vector>
+
+/**
+ * Ferme et retire une connexion Qt (ne fait rien si elle n'existe plus)
+ * @param name Nom de la connexion
+ */
+static void removeConnection(const QString& name)
+{
+    if(!QSqlDatabase::contains(name))
+        return;
+
+    {
+        QSqlDatabase db = QSqlDatabase::database(name, false);
+        db.close();
+    }
+    QSqlDatabase::removeDatabase(name); // Once no handle uses it anymore
+}
+
+/**
+ * Connexions ouvertes par un thread, fermées quand le thread se termine (dans ce thread)
+ */
+struct ThreadConnections
+{
+    std::vector<QString> names; /*!< Noms des connexions du thread */
+
+    ~ThreadConnections()
+    {
+        for(const QString& name : names)
+            removeConnection(name);
+    }
+};
+
+static thread_local ThreadConnections threadConnections; /*!< Connexions du thread courant */
+
+/**
+ * Renvoie le nom de la connexion du thread courant
+ * @return Nom de la connexion
+ */
+QString ConnectionPool::nameOf() const
+{
+    const std::size_t thread = std::hash<std::thread::id>()(std::this_thread::get_id());
+    return this->prefix + QString::number(static_cast<qulonglong>(thread));
+}
+
+/**
+ * Choisit la base de données des prochaines connexions (les connexions déjà ouvertes sont fermées)
+ * @param databasePath Chemin de la base de données SQLite
+ * @param connectionPragmas Réglages (PRAGMA) à exécuter à l'ouverture de chaque connexion
+ */
+void ConnectionPool::setDatabase(const QString& databasePath, const QStringList& connectionPragmas)
+{
+    closeAll();
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->path = databasePath;
+    this->pragmas = connectionPragmas;
+}
+
+/**
+ * Renvoie la connexion en lecture seule du thread courant, ouverte à la première demande du thread.
+ * La connexion ne doit être utilisée que dans ce thread.
+ * @return Connexion du thread (fermée si la base de données n'a pas pu être ouverte)
+ */
+QSqlDatabase ConnectionPool::connection()
+{
+    const QString name = nameOf();
+    if(QSqlDatabase::contains(name))
+        return QSqlDatabase::database(name);
+
+    QString databasePath;
+    QStringList connectionPragmas;
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        databasePath = this->path;
+        connectionPragmas = this->pragmas;
+    }
+
+    QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", name);
+    db.setDatabaseName(databasePath);
+    db.setConnectOptions("QSQLITE_OPEN_READONLY;QSQLITE_BUSY_TIMEOUT=5000"); // Without WAL, a read blocks the writer
+    if(!db.open())
+        qDebug() << "Connexion de lecture impossible :" << db.lastError().text();
+    for(const QString& pragma : connectionPragmas)
+        QSqlQuery(db).exec(pragma);
+
+    if(std::find(threadConnections.names.begin(), threadConnections.names.end(), name)
+            == threadConnections.names.end())
+        threadConnections.names.push_back(name);
+    return db;
+}
+
+/**
+ * Ferme la connexion du thread courant (elle sera rouverte à la prochaine demande)
+ */
+void ConnectionPool::release()
+{
+    removeConnection(nameOf());
+}
+
+/**
+ * Ferme toutes les connexions du pool. Aucune lecture ne doit être en cours dans un autre thread.
+ */
+void ConnectionPool::closeAll()
+{
+    for(const QString& name : QSqlDatabase::connectionNames())
+        if(name.startsWith(this->prefix))
+            removeConnection(name);
+}
+
+/**
+ * Constructeur du pool (les connexions sont ouvertes à la demande, voir setDatabase et connection)
+ * @param prefix Début du nom des connexions, propre à ce pool
+ */
+ConnectionPool::ConnectionPool(QString prefix) : prefix(std::move(prefix))
+{
+}
+
+/**
+ * Destructeur : ferme les connexions restantes
+ */
+ConnectionPool::~ConnectionPool()
+{
+    closeAll();
+}
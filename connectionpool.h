@@ -0,0 +1,50 @@
+/**
+ * @file connectionpool.h
+ *
+ * @brief Déclaration de la classe ConnectionPool (connexions de lecture, une par thread)
+ *
+ * @author LEESTMANS Richard
+ * @author COUDERT Nicolas
+ */
+
+#ifndef CDAA_CONNECTIONPOOL_H
+#define CDAA_CONNECTIONPOOL_H
+
+#include <QtSql>
+#include <mutex>
+
+/**
+ * Connexions en lecture seule vers la base de données SQLite, une par thread, utilisées par DBInterface pour les
+ * lectures qui ne passent pas par le cache (exportation, statistiques, rapports).
+ * Une connexion Qt ne s'utilise que dans le thread qui l'a ouverte : chaque thread reçoit sa propre connexion
+ * nommée, ouverte à sa première demande et fermée à la fin du thread. Seul le journal WAL (profils "balanced" et
+ * "fast", voir StorageProfile) permet à ces lectures de ne bloquer ni les autres lecteurs ni le thread d'écriture :
+ * des travaux de lecture parallèles (std::async) profitent alors de tous les cœurs. Avec le profil par défaut
+ * ("safe", journal DELETE), une lecture de table entière bloque les écritures jusqu'à sa fin (le thread d'écriture
+ * attend jusqu'à 5 s avant d'échouer).
+ * \brief Connexions de lecture, une par thread
+ */
+class ConnectionPool
+{
+private:
+    QString prefix; /*!< Début du nom des connexions (suivi de l'identifiant du thread) */
+    QString path; /*!< Chemin de la base de données */
+    QStringList pragmas; /*!< Réglages exécutés à l'ouverture de chaque connexion */
+    std::mutex mutex; /*!< Protège path et pragmas */
+
+    [[nodiscard]] QString nameOf() const;
+
+public:
+    // Voir connectionpool.cpp pour la documentation des méthodes
+    void setDatabase(const QString& databasePath, const QStringList& connectionPragmas = QStringList());
+    [[nodiscard]] QSqlDatabase connection();
+    void release();
+    void closeAll();
+
+    explicit ConnectionPool(QString prefix);
+    ConnectionPool(const ConnectionPool&) = delete;
+    ConnectionPool& operator=(const ConnectionPool&) = delete;
+    ~ConnectionPool();
+};
+
+#endif // CDAA_CONNECTIONPOOL_H
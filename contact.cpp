@@ -45,6 +45,7 @@ void Contact::setLastName(const std::string & lastName)
 {
     this->lastName = lastName;
     this->lastName[0] = toupper(this->lastName[0]);
+    this->collationKey = Utils::collationKey(this->lastName, this->firstName);
 }
 
 /**
@@ -64,6 +65,7 @@ void Contact::setFirstName(const std::string & firstName)
 {
     this->firstName = firstName;
     this->firstName[0] = toupper(this->firstName[0]);
+    this->collationKey = Utils::collationKey(this->lastName, this->firstName);
 }
 
 /**
@@ -130,6 +132,16 @@ std::string Contact::getFullName() const
     return lastName + " " + firstName;
 }
 
+/**
+ * Renvoie la clé de tri du Contact sur son nom complet.
+ * Deux clés se comparent octet par octet, sans tenir compte des accents ni de la casse.
+ * @return Clé de tri
+ */
+const std::string& Contact::getCollationKey() const
+{
+    return collationKey;
+}
+
 /**
  * Renvoie la note actuelle du Contact
  * @return Note du Contact
@@ -148,40 +160,6 @@ void Contact::setNote(const std::string& note)
     this->note = note;
 }
 
-/**
- * Renvoie les interactions du Contact
- * @return Interactions du Contact
- */
-const Interactions &Contact::getInteractions() const {
-    return this->interactions;
-}
-
-/**
- * Renvoie une interaction du Contact gâce à son id
- * @param id Identifiant de l'Interaction cherché
- * @return Interaction voulue
- */
-Interaction* Contact::getInteraction(int id) {
-    return this->interactions.getInteraction(id);
-}
-
-/**
- * Ajoute une Interaction au Contact
- * @param interaction Interaction à attribuer au contact
- */
-void Contact::addInteraction(Interaction &interaction) {
-    interaction.setOwnerId(this->id);
-    this->interactions.addInteraction(interaction);
-}
-
-/**
- * Tri les interactions du Contact par ordre chronologique
- * @param reverse Inverser l'ordre ?
- */
-void Contact::sortInteractions(bool reverse) {
-    this->interactions.sortByDate(reverse);
-}
-
 /**
  * Renvoie la date de création du Contact
  * @return Date de création
@@ -199,150 +177,92 @@ void Contact::setCreationDate(const Date &date) {
 }
 
 /**
- * Renvoie la liste des Todo du Contact sous forme de Todos
- * @return Todos de Todo du Contact
- */
-const Todos &Contact::getTodos() const {
-    return this->todos;
-}
-
-/**
- * Renvoie un Todo reconnu par son identifiant
- * @param id Identifiant du Todo voulu
- * @return Todo recherché
- */
-Todo *Contact::getTodo(int id) {
-    return this->todos.getTodo(id);
-}
-
-/**
- * Ajoute un Todo à la liste Todos du Contact
- * @param todo Todo à ajouter
+ * Relie le Contact aux listes où sont stockées ses interactions et ses tâches.
+ * Les listes ne sont pas copiées : elles doivent survivre au Contact (et à ses copies).
+ * @param interactions Liste des interactions (nullptr: aucune)
+ * @param todos Liste des tâches (nullptr: aucune)
  */
-void Contact::addTodo(Todo &todo) {
-    this->todos.addTodo(todo);
+void Contact::attach(const Interactions* interactions, const Todos* todos) {
+    this->interactionStore = interactions;
+    this->todoStore = todos;
 }
 
 /**
- * Tri les tâches du Contact par ordre chronologique
- * @param reverse Inverser l'ordre ?
+ * Renvoie une vue sur les interactions du Contact, par ordre chronologique
+ * @param reverse Du plus récent au plus ancien ? (false par défaut)
+ * @return Interactions du Contact (vue vide si le Contact n'est relié à aucune liste)
  */
-void Contact::sortTodos(bool reverse) {
-    this->todos.sortByDate(reverse);
+View<Interaction> Contact::getInteractions(bool reverse) const {
+    if(!this->interactionStore)
+        return View<Interaction>();
+    return this->interactionStore->getInteractionsOf(this->id, reverse);
 }
 
 /**
- * Renvoie les Interaction situées entre deux dates sous forme d'Interactions
+ * Renvoie une vue sur les Interaction situées entre deux dates, par ordre chronologique (index des dates)
  * @param to Date de début de recherche
  * @param from Date de fin de recherche
- * @return Interactions avec les interactions concernées
+ * @return Vue sur les interactions concernées
  */
-Interactions Contact::getInteractionsBetween(Date &to, Date &from) {
-    return this->interactions.getInteractionsBetween(to, from);
+View<Interaction> Contact::getInteractionsBetween(const Date &to, const Date &from) const {
+    if(!this->interactionStore)
+        return View<Interaction>();
+    return this->interactionStore->getInteractionsOfBetween(this->id, to, from);
 }
 
 /**
- * Renvoie les Interaction s sans date, donc urgentes
+ * Renvoie une vue sur les Interaction s sans date, donc urgentes
  * @return Interaction s sans date.
  */
-Interactions Contact::getUrgentInteractions() {
-    return this->interactions.getUrgentInteractions();
+View<Interaction> Contact::getUrgentInteractions() const {
+    return getInteractions().where([](const Interaction& i) { return i.isUrgent(); });
 }
 
 /**
- * Définit une nouvelle liste d'interactions
- * @param is Nouvelle liste d'interactions
+ * Renvoie le nombre d'interactions du Contact (sans les parcourir)
+ * @return Nombre d'interactions
  */
-void Contact::setInteractions(Interactions is)
-{
-    interactions = is;
+std::size_t Contact::getInteractionCount() const {
+    return this->interactionStore ? this->interactionStore->countOf(this->id) : 0;
 }
 
 /**
- * Vide la liste des interactions actuelle
+ * Renvoie une vue sur les tâches du Contact, par ordre chronologique
+ * @param reverse Du plus récent au plus ancien ? (false par défaut)
+ * @return Tâches du Contact (vue vide si le Contact n'est relié à aucune liste)
  */
-void Contact::clearInteractions()
-{
-    interactions.clear();
+View<Todo> Contact::getTodos(bool reverse) const {
+    if(!this->todoStore)
+        return View<Todo>();
+    return this->todoStore->getTodosOf(this->id, reverse);
 }
 
 /**
- * Renvoie les todo situées entre deux dates sous forme de Todos
+ * Renvoie une vue sur les todo situés entre deux dates, par ordre chronologique (index des dates)
  * @param to Date de début de recherche
  * @param from Date de fin de recherche
- * @return Todos avec les Todo concernés
+ * @return Vue sur les Todo concernés
  */
-Todos Contact::getTodosBetween(Date &to, Date &from) {
-    return this->todos.getTodosBetween(to, from);
+View<Todo> Contact::getTodosBetween(const Date &to, const Date &from) const {
+    if(!this->todoStore)
+        return View<Todo>();
+    return this->todoStore->getTodosOfBetween(this->id, to, from);
 }
 
 /**
- * Renvoie les tâches sans date, donc urgentes.
+ * Renvoie une vue sur les tâches sans date, donc urgentes.
  * @return Tâche (Todo) sans date.
  */
-Todos Contact::getUrgentTodos() {
-    return this->todos.getUrgentTodos();
-}
-
-/**
- * Définit une nouvelle liste de tâches
- * @param ts Nouvelle liste de tâches
- */
-void Contact::setTodos(Todos ts)
-{
-    todos = ts;
-}
-
-/**
- * Vide la liste des tâches actuelle
- */
-void Contact::clearTodos()
-{
-    todos.clear();
+View<Todo> Contact::getUrgentTodos() const {
+    return getTodos().where([](const Todo& t) { return t.isUrgent(); });
 }
 
 /**
- * Renvoie la query qui concerne l'objet en fonction du mode.
- *  -> voir dbinterface.cpp pour le mode
- * @param mode Mode (CREATE, UPDATE, DELETE)
- * @return Query
+ * Renvoie le nombre de tâches du Contact (sans les parcourir)
+ * @return Nombre de tâches
  */
-std::string Contact::getQuery(int mode)
-{
-    if(mode == DELETE)
-        return "DELETE FROM contact WHERE id=" + std::to_string(this->id);
-
-    // Secure to prevent SQL Injections
-    Utils::addSlashes(this->firstName);
-    Utils::addSlashes(this->lastName);
-    Utils::addSlashes(this->company);
-    Utils::addSlashes(this->phone);
-    Utils::addSlashes(this->email);
-    Utils::addSlashes(this->note);
-
-    switch(mode)
-    {
-        case UPDATE:
-            return "UPDATE contact SET "
-                   "first_name='"+firstName+"', "
-                   "last_name='"+lastName+"', "
-                   "company='"+company+"', "
-                   "email='"+email+"', "
-                   "phone='"+phone+"', "
-                   "creation_date='"+creationDate.getSqlFormat()+"', "
-                   "note='"+note+"' "
-                   "WHERE id="+std::to_string(id);
-        case CREATE:
-            return "INSERT INTO contact "
-                   "(first_name, last_name, company, email, phone, creation_date, note) "
-                   "VALUES "
-                   "('"+firstName+"', '"+lastName+"', '"+company+"', '"+
-                    email+"', '"+phone+"', '"+creationDate.getSqlFormat()+"', '" + note +"')";
-        default:
-            break;
-    }
-
-    return "";
+std::size_t Contact::getTodoCount() const {
+    return this->todoStore ? this->todoStore->countOf(this->id) : 0;
 }
 
 /**
@@ -371,7 +291,7 @@ std::unordered_map<std::string, std::string> Contact::toMap() const
  * @return S'ils sont égaux
  */
 bool operator==(const Contact &a, const Contact &b) {
-    return a.id == b.id && a.getFullName() == b.getFullName();
+    return a.id == b.id && a.lastName == b.lastName && a.firstName == b.firstName;
 }
 
 /**
@@ -384,36 +304,6 @@ bool operator!=(const Contact &a, const Contact &b) {
     return !(a==b);
 }
 
-/**
- * Ajoute d'une liste de Todos au Contact a.
- * @param a Contact
- * @param b Liste de Todos
- * @return Contact modifié.
- */
-Contact& operator+=(Contact &a, Todos &b) {
-    for(auto& t: b)
-    {
-        t.setOwnerId(a.getId());
-        a.addTodo(t);
-    }
-    return a;
-}
-
-/**
- * Ajoute d'une liste d'Interactions au Contact a.
- * @param a Contact
- * @param b Liste d'Interactions
- * @return Contact modifié.
- */
-Contact& operator+=(Contact &a, Interactions &b) {
-    for(auto& i: b)
-    {
-        i.setOwnerId(a.getId());
-        a.addInteraction(i);
-    }
-    return a;
-}
-
 /**
  * Renvoie une description textuelle de l'objet dans le flux
  * @param os Flux
@@ -427,8 +317,8 @@ std::ostream &operator<<(std::ostream &os, const Contact &c) {
     os << c.getCompany();
     os << ", ";
     os << c.getCreationDate();
-    os << ", Interactions("<< c.getInteractions().size() << ")";
-    os << ", Todos(" << c.getTodos().size() << ")";
+    os << ", Interactions("<< c.getInteractionCount() << ")";
+    os << ", Todos(" << c.getTodoCount() << ")";
     os << ">";
     return os;
 }
@@ -438,6 +328,8 @@ std::ostream &operator<<(std::ostream &os, const Contact &c) {
  */
 Contact::Contact() {
     this->id = -1;
+    this->interactionStore = nullptr;
+    this->todoStore = nullptr;
 }
 
 /**
@@ -447,8 +339,11 @@ Contact::Contact() {
  */
 Contact::Contact(std::string firstName, std::string lastName) {
     this->id = -1;
+    this->interactionStore = nullptr;
+    this->todoStore = nullptr;
     this->firstName = std::move(firstName);
     this->lastName = std::move(lastName);
+    this->collationKey = Utils::collationKey(this->lastName, this->firstName);
 }
 
 Contact::~Contact() = default;
@@ -33,7 +33,9 @@
  *      Son email
  *      Son numéro de téléphone
  *      Sa date de création
- * Un contact a également des interactions et une liste de tâche (TODO) à faire
+ * Un contact a également des interactions et une liste de tâche (TODO) à faire. Elles ne sont pas copiées dans le
+ * contact : elles sont stockées une seule fois dans les listes de l'application (voir attach), le contact n'en expose
+ * que des vues. La copie d'un contact ne copie donc pas son historique.
  *
  * \brief Modélisation d'un Contact avec ses attributs
  */
@@ -42,13 +44,14 @@ private:
     int id; /*!< Identifiant du contact (-1 si non connu). */
     std::string lastName; /*!< Nom du contact. */
     std::string firstName; /*!< Prénom du contact. */
+    std::string collationKey; /*!< Clé de tri sur le nom complet (voir Utils::collationKey), mise à jour avec le nom. */
     std::string company; /*!< Entreprise du contact. */
     std::string email; /*!< Adresse email du contact. */
     std::string phone; /*!< Numéro de téléphone du contact. */
     std::string note; /*!< Note concernant le contact */
     Date creationDate; /*!< Date de création du Contact. */
-    Interactions interactions; /*!< Liste des interactions liées au contact. */
-    Todos todos; /*!< Liste des tâches liées au contact. */
+    const Interactions* interactionStore; /*!< Liste (non possédée) où sont stockées les interactions du contact. */
+    const Todos* todoStore; /*!< Liste (non possédée) où sont stockées les tâches du contact. */
 
 public:
     // Voir contact.cpp pour la documentation des méthodes
@@ -76,35 +79,27 @@ public:
     [[nodiscard]] const std::string &getNote() const;
     void setNote(const std::string& note);
 
-    [[nodiscard]] const Interactions& getInteractions()  const;
-    [[nodiscard]] Interaction* getInteraction(int id);
-    [[nodiscard]] Interactions getInteractionsBetween(Date& to, Date& from);
-    [[nodiscard]] Interactions getUrgentInteractions();
-    void setInteractions(Interactions is);
-    void addInteraction(Interaction& interaction);
-    void sortInteractions(bool reverse=false);
-    void clearInteractions();
-
-    [[nodiscard]] const Todos& getTodos()  const;
-    [[nodiscard]] Todo* getTodo(int id);
-    [[nodiscard]] Todos getTodosBetween(Date& to, Date& from);
-    [[nodiscard]] Todos getUrgentTodos();
-    void setTodos(Todos ts);
-    void addTodo(Todo& todo);
-    void sortTodos(bool reverse=false);
-    void clearTodos();
-
-    [[nodiscard]] std::string getQuery(int mode);
+    void attach(const Interactions* interactions, const Todos* todos);
+
+    [[nodiscard]] View<Interaction> getInteractions(bool reverse=false) const;
+    [[nodiscard]] View<Interaction> getInteractionsBetween(const Date& to, const Date& from) const;
+    [[nodiscard]] View<Interaction> getUrgentInteractions() const;
+    [[nodiscard]] std::size_t getInteractionCount() const;
+
+    [[nodiscard]] View<Todo> getTodos(bool reverse=false) const;
+    [[nodiscard]] View<Todo> getTodosBetween(const Date& to, const Date& from) const;
+    [[nodiscard]] View<Todo> getUrgentTodos() const;
+    [[nodiscard]] std::size_t getTodoCount() const;
+
 
     // Virtual
     [[nodiscard]] std::string getFullName() const;
+    [[nodiscard]] const std::string& getCollationKey() const;
 
     std::unordered_map<std::string, std::string> toMap() const;
 
     friend bool operator==(const Contact& a, const Contact& b);
     friend bool operator!=(const Contact& a, const Contact& b);
-    friend Contact& operator+=(Contact&a, Todos& b);
-    friend Contact& operator+=(Contact&a, Interactions &b);
     friend std::ostream& operator<<(std::ostream& os, const Contact& i);
 
     Contact();
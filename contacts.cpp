@@ -10,19 +10,51 @@
 #include "contacts.h"
 
 /**
- * Ajoute un Contact à la liste
+ * Ajoute un Contact à la liste.
+ * Si un Contact avec le même identifiant existe déjà, il est remplacé (c'est ainsi qu'un Contact est mis à jour).
  * @param c Contact à ajouter
  */
 void Contacts::addContact(const Contact& c) {
-    this->contacts.push_back(c);
+    if(!this->interactionStore && !this->todoStore) {
+        this->contacts.add(c);
+        return;
+    }
+
+    Contact attached = c;
+    attached.attach(this->interactionStore, this->todoStore);
+    this->contacts.add(attached);
+}
+
+/**
+ * Relie la liste (et chacun de ses Contact) aux listes d'interactions et de tâches de l'application.
+ * Les listes ne sont pas copiées : elles doivent survivre à cette liste.
+ * @param interactions Liste des interactions
+ * @param todos Liste des tâches
+ */
+void Contacts::attach(const Interactions* interactions, const Todos* todos) {
+    this->interactionStore = interactions;
+    this->todoStore = todos;
+    const std::vector<Contact> attached = this->contacts.data(); // Replaced one by one (read-only store)
+    for(Contact c : attached) {
+        c.attach(interactions, todos);
+        this->contacts.add(c);
+    }
+}
+
+/**
+ * Renvoie les Contact de la liste
+ * @return Contact (stockage contigu)
+ */
+const std::vector<Contact>& Contacts::getContacts() const {
+    return this->contacts.data();
 }
 
 /**
- * Renvoie une liste de Contact
- * @return Liste de Contact
+ * Réserve la place pour un nombre de Contact donné (évite les réallocations lors d'un chargement)
+ * @param count Nombre de Contact attendus
  */
-std::list<Contact> Contacts::getContacts() {
-    return this->contacts;
+void Contacts::reserve(std::size_t count) {
+    this->contacts.reserve(count);
 }
 
 /**
@@ -41,41 +73,53 @@ unsigned int Contacts::size() const {
 }
 
 /**
- * Renvoie un pointeur sur un Contact cherché grâce à son identifiant
+ * Renvoie un pointeur constant sur un Contact cherché grâce à son identifiant
  * @param id Identifiant du Contact à chercher
  * @return Pointeur sur le Contact (nullptr si non trouvé)
  */
-Contact* Contacts::getContact(int id) {
-    for(auto& c : this->contacts)
-        if(c.getId() == id)
-            return &c;
-    return nullptr;
+const Contact* Contacts::getContact(int id) const {
+    return this->contacts.get(id);
 }
 
 /**
- * Cherche un Contact grâce à son nom.
+ * Cherche les Contact dont un champ contient un texte, sans tenir compte de la casse ni des accents.
+ * @param text Texte recherché
+ * @param fields Champs où chercher (combinaison de TrigramIndex::Field)
+ * @return Identifiants des Contact trouvés (triés)
+ */
+std::vector<int> Contacts::search(const std::string& text, unsigned int fields) const {
+    return this->contacts.index<ContactText>().get().search(text, fields);
+}
+
+/**
+ * Renvoie une vue sur les Contact donnés par leur identifiant (poignée stable).
+ * Chaque identifiant est résolu au parcours : un Contact supprimé entre temps est ignoré.
+ * @param ids Identifiants des Contact
+ * @return Vue sur les Contact, dans l'ordre des identifiants
+ */
+View<Contact> Contacts::fromIds(std::vector<int> ids) const {
+    auto handles = std::make_shared<const std::vector<int>>(std::move(ids));
+    const Contacts* self = this;
+    return View<Contact>::byIds([handles]() { return handles.get(); },
+                                [self](int id) { return self->getContact(id); });
+}
+
+/**
+ * Cherche un Contact grâce à son nom (sans tenir compte de la casse ni des accents).
  * @param name Nom recherché
- * @return Contacts contenant les Contact recherchés
+ * @return Vue sur les Contact recherchés (aucun Contact n'est copié)
  */
-Contacts Contacts::searchByName(const std::string& name) {
-    Contacts cs;
-    for(auto& c : this->contacts)
-        if(c.getFullName().find(name) != std::string::npos)
-            cs.addContact(c);
-    return cs;
+View<Contact> Contacts::searchByName(const std::string& name) const {
+    return fromIds(this->contacts.index<ContactText>().get().search(name, TrigramIndex::NAME));
 }
 
 /**
- * Cherche un Contact grâce à son entreprise
+ * Cherche un Contact grâce à son entreprise (sans tenir compte de la casse ni des accents).
  * @param company Entreprise recherchée
- * @return Contacts contenant les Contact recherchés
+ * @return Vue sur les Contact recherchés (aucun Contact n'est copié)
  */
-Contacts Contacts::searchByCompany(const std::string &company) {
-    Contacts cs;
-    for(auto& c : this->contacts)
-        if(c.getCompany().find(company) != std::string::npos)
-            cs.addContact(c);
-    return cs;
+View<Contact> Contacts::searchByCompany(const std::string &company) const {
+    return fromIds(this->contacts.index<ContactText>().get().search(company, TrigramIndex::COMPANY));
 }
 
 /**
@@ -90,108 +134,138 @@ void Contacts::sortByDate(bool reverse) {
 }
 
 /**
- * Tri l'ensemble des Contact s par leur nom
+ * Tri l'ensemble des Contact s par leur nom (ordre alphabétique, sans tenir compte des accents ni de la casse).
+ * Les clés de tri sont précalculées par chaque Contact : la comparaison ne fait aucune allocation.
  * @param reverse Inverser le tri ou non
  */
 void Contacts::sortByName(bool reverse) {
     if(reverse)
-        this->contacts.sort([](const Contact &c, const Contact &c1) {return c.getFullName() > c1.getFullName();});
+        this->contacts.sort([](const Contact &c, const Contact &c1) {return c.getCollationKey() > c1.getCollationKey();});
     else
-        this->contacts.sort([](const Contact &c, const Contact &c1) {return c.getFullName() < c1.getFullName();});
+        this->contacts.sort([](const Contact &c, const Contact &c1) {return c.getCollationKey() < c1.getCollationKey();});
 }
 
 /**
- * Renvoie l'ensemble de TODO existant entre deux Date s
+ * Renvoie une vue sur les TODO de tous les Contact de la liste
+ * @return Vue sur les TODO (vide si la liste n'est reliée à aucune liste de tâches)
+ */
+View<Todo> Contacts::getAllTodos() const {
+    if(!this->todoStore)
+        return View<Todo>();
+    const Contacts* self = this;
+    return View<Todo>::of(*this->todoStore).where([self](const Todo& t) {
+        return self->getContact(t.getOwnerId()) != nullptr;
+    });
+}
+
+/**
+ * Renvoie une vue sur l'ensemble des TODO existant entre deux Date s, par ordre chronologique (index des dates)
  * @param to Date de début
  * @param from Date de fin
- * @return Todos avec les TODO recherchés
+ * @return Vue sur les TODO recherchés
+ */
+View<Todo> Contacts::getTodosBetween(Date to, Date from) const {
+    if(!this->todoStore)
+        return View<Todo>();
+    const Contacts* self = this;
+    return this->todoStore->getTodosBetween(to, from).where([self](const Todo& t) {
+        return self->getContact(t.getOwnerId()) != nullptr;
+    });
+}
+
+/**
+ * Renvoie une vue sur l'ensemble des TODO les plus urgents (sans Date), lus dans l'index des tâches urgentes
+ * @return Vue sur les TODO urgents
  */
-Todos Contacts::getTodosBetween(Date to, Date from) {
-    Todos ts;
-    for(auto& c: this->contacts)
-        ts += c.getTodosBetween(to, from);
-    return ts;
+View<Todo> Contacts::getUrgentTodos() const {
+    if(!this->todoStore)
+        return View<Todo>();
+    const Contacts* self = this;
+    return this->todoStore->getUrgentTodos().where([self](const Todo& t) {
+        return self->getContact(t.getOwnerId()) != nullptr;
+    });
 }
 
 /**
- * Renvoie un TODOS avec l'ensemble des TODO les plus urgents (sans Date)
- * @return TODOS avec les TODO urgents
+ * Renvoie une vue sur les Interaction s de tous les Contact de la liste
+ * @return Vue sur les Interaction s (vide si la liste n'est reliée à aucune liste d'interactions)
  */
-Todos Contacts::getUrgentTodos() {
-    Todos ts;
-    for(auto& c: this->contacts)
-        ts += c.getUrgentTodos();
-    return ts;
+View<Interaction> Contacts::getAllInteractions() const {
+    if(!this->interactionStore)
+        return View<Interaction>();
+    const Contacts* self = this;
+    return View<Interaction>::of(*this->interactionStore).where([self](const Interaction& i) {
+        return self->getContact(i.getOwnerId()) != nullptr;
+    });
 }
 
 /**
- * Renvoie une Interactions contenant toutes les Interaction s entre deux Date s
+ * Renvoie une vue sur toutes les Interaction s entre deux Date s, par ordre chronologique (index des dates)
  * @param to Date de début
  * @param from Date de fin
- * @return Interactions avec les Interactions recherchées
+ * @return Vue sur les Interaction s recherchées
  */
-Interactions Contacts::getInteractionsBetween(Date to, Date from) {
-    Interactions is;
-    for(auto& c: this->contacts)
-        is += c.getInteractionsBetween(to, from);
-    return is;
+View<Interaction> Contacts::getInteractionsBetween(Date to, Date from) const {
+    if(!this->interactionStore)
+        return View<Interaction>();
+    const Contacts* self = this;
+    return this->interactionStore->getInteractionsBetween(to, from).where([self](const Interaction& i) {
+        return self->getContact(i.getOwnerId()) != nullptr;
+    });
 }
 
 /**
- * Renvoie sous forme d'Interactions l'ensemble des Interaction s urgentes (sans Date)
- * @return Interactions avec les Interaction s urgente
+ * Renvoie une vue sur l'ensemble des Interaction s urgentes (sans Date), lues dans l'index des interactions urgentes
+ * @return Vue sur les Interaction s urgentes
  */
-Interactions Contacts::getUrgentInteractions() {
-    Interactions is;
-    for(auto& c: this->contacts)
-        is += c.getUrgentInteractions();
-    return is;
+View<Interaction> Contacts::getUrgentInteractions() const {
+    if(!this->interactionStore)
+        return View<Interaction>();
+    const Contacts* self = this;
+    return this->interactionStore->getUrgentInteractions().where([self](const Interaction& i) {
+        return self->getContact(i.getOwnerId()) != nullptr;
+    });
 }
 
 /**
- * Retire un Contact de la liste avec son identifiant
+ * Retire un Contact de la liste avec son identifiant.
+ * Le dernier Contact prend la place de celui supprimé (l'ordre de la liste n'est pas conservé).
  * @param id Identifiant du Contact a supprimer
  */
 void Contacts::remove(int id) {
-    for(auto& c: this->contacts)
-        if(c.getId() == id) {
-            this->contacts.remove(c);
-            return; //prevent access memory violation
-        }
+    this->contacts.remove(id);
 }
 
 /**
- * Renvoie l'ensemble des Interaction s sous forme d'Interactions classées par Date
+ * Renvoie une vue sur l'ensemble des Interaction s des Contact s classées par Date.
+ * L'historique (déjà trié) de chaque Contact est fusionné au fil du parcours : rien n'est copié ni trié.
  * @param reverse Inverser le tri ?
- * @return Interactions triées par Date
+ * @return Vue sur les Interaction s triées par Date
  */
-Interactions Contacts::getInteractionsSortedByDate(bool reverse) {
-    Interactions is;
-    for(auto& c: this->contacts)
-        is += c.getInteractions();
-    is.sortByDate(reverse);
-    return is;
+View<Interaction> Contacts::getInteractionsSortedByDate(bool reverse) const {
+    if(!this->interactionStore)
+        return View<Interaction>();
+    std::vector<int> ids;
+    ids.reserve(this->contacts.size());
+    for(const auto& c: this->contacts)
+        ids.push_back(c.getId());
+    return this->interactionStore->getInteractionsByDate(std::move(ids), reverse);
 }
 
 /**
- * Renvoie l'ensemble des TODO s sous forme d'un TODOS classés par Date
+ * Renvoie une vue sur l'ensemble des TODO s des Contact s classés par Date.
+ * Les tâches (déjà triées) de chaque Contact sont fusionnées au fil du parcours : rien n'est copié ni trié.
  * @param reverse Inverser le tri ?
- * @return TODOS triés par Date
+ * @return Vue sur les TODO s triés par Date
  */
-Todos Contacts::getTodosSortedByDate(bool reverse) {
-    Todos ts;
-    for(auto& c: this->contacts)
-        ts += c.getTodos();
-    ts.sortByDate(reverse);
-    return ts;
-}
-
-/**
- * Itérateur qui pointe sur le début de la liste
- * @return Itérateur début
- */
-Contacts::iterator Contacts::begin() {
-    return this->contacts.begin();
+View<Todo> Contacts::getTodosSortedByDate(bool reverse) const {
+    if(!this->todoStore)
+        return View<Todo>();
+    std::vector<int> ids;
+    ids.reserve(this->contacts.size());
+    for(const auto& c: this->contacts)
+        ids.push_back(c.getId());
+    return this->todoStore->getTodosByDate(std::move(ids), reverse);
 }
 
 /**
@@ -202,14 +276,6 @@ Contacts::const_iterator Contacts::begin() const {
     return this->contacts.begin();
 }
 
-/**
- * Itérateur qui pointe sur la fin de la liste
- * @return Itérateur fin
- */
-Contacts::iterator Contacts::end() {
-    return this->contacts.end();
-}
-
 /**
  * Itérateur constant qui pointe sur la fin de la liste
  * @return Itérateur constant fin
@@ -234,16 +300,16 @@ std::ostream& operator<<(std::ostream& os, const Contacts &c) {
 /**
  * Constructeur sans paramètre: initialise juste la liste de Contact s
  */
-Contacts::Contacts() {
-    this->contacts = std::list<Contact>();
-}
+Contacts::Contacts() = default;
 
 /**
  * Constructeur avec une liste de Contact à ajouter dans l'objet
  * @param c Liste de Contact s
  */
-Contacts::Contacts(std::list <Contact> c) {
-    this->contacts = std::move(c);
+Contacts::Contacts(std::vector<Contact> c) {
+    this->contacts.reserve(c.size());
+    for(const auto& contact : c)
+        this->contacts.add(contact);
 }
 
 /**
@@ -251,8 +317,7 @@ Contacts::Contacts(std::list <Contact> c) {
  * @param c Contact à ajouter à l'objet
  */
 Contacts::Contacts(const Contact& c) {
-    this->contacts = std::list<Contact>();
-    this->contacts.push_back(c);
+    addContact(c);
 }
 
 /**
@@ -11,63 +11,120 @@
 #define CDAA_CONTACTS_H
 
 #include <list>
+#include <memory>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
 #include <string>
 #include <iostream>
 #include <QtSql>
 #include "contact.h"
+#include "entitystore.h"
 #include "interactions.h"
 #include "interaction.h"
 #include "todos.h"
 #include "todo.h"
+#include "trigramindex.h"
+#include "view.h"
 
+/**
+ * Index secondaire des Contact (voir EntityStore) : texte (nom complet, entreprise, email, téléphone, identifiant et
+ * date de création) dans un index de trigrammes
+ */
+class ContactText
+{
+private:
+    TrigramIndex index; /*!< Index de recherche sur le texte des Contact */
+
+public:
+    /**
+     * Ajoute (ou remplace) le texte d'un Contact dans l'index de recherche
+     * @param c Contact à indexer
+     */
+    void link(const Contact& c)
+    {
+        this->index.add(c.getId(), c.getFullName(), c.getCompany(), c.getEmail(), c.getPhone(),
+                        c.getCreationDate().getDateCompactString());
+    }
+
+    /**
+     * Retire un Contact de l'index de recherche
+     * @param c Contact indexé
+     */
+    void unlink(const Contact& c) { this->index.remove(c.getId()); }
+
+    /**
+     * Vide l'index
+     */
+    void clear() { this->index.clear(); }
+
+    /**
+     * Renvoie l'index de recherche
+     * @return Index de trigrammes
+     */
+    [[nodiscard]] const TrigramIndex& get() const { return this->index; }
+};
 
 /**
  * Objet pour manier plus facilement une liste de Contact.
+ * Les Contact sont stockés de manière contiguë et indexés par leur identifiant (voir EntityStore): la recherche et la
+ * suppression d'un Contact se font en temps constant. L'identifiant sert de poignée stable vers un Contact, les pointeurs et
+ * itérateurs sont invalidés par un ajout ou une suppression.
+ * Un index de trigrammes (nom complet, entreprise, email, téléphone, identifiant, date de création) est tenu à jour à
+ * chaque ajout, remplacement ou suppression : un Contact doit donc être modifié en le remplaçant (addContact), getContact() et les itérateurs sont constants.
+ * La liste peut être reliée aux listes d'interactions et de tâches de l'application (attach) : chaque Contact ajouté y
+ * est relié, les requêtes sur l'ensemble des tâches et des interactions passent directement par ces listes.
  * \brief Liste de Contact permettant une gestion plus facile et opérations spécifiques
  */
 class Contacts {
 private:
-    std::list<Contact> contacts; /*!< Liste des Contact modélisés par cette classe. */
+    EntityStore<Contact, ContactText> contacts; /*!< Contact modélisés par cette classe (stockage contigu et index). */
+    const Interactions* interactionStore = nullptr; /*!< Liste (non possédée) des interactions des Contact. */
+    const Todos* todoStore = nullptr; /*!< Liste (non possédée) des tâches des Contact. */
+
+    [[nodiscard]] View<Contact> fromIds(std::vector<int> ids) const;
 
 public:
     // Voir contacts.cpp pour la documentation des méthodes
 
+    void attach(const Interactions* interactions, const Todos* todos);
     void addContact(const Contact& c);
-    std::list<Contact> getContacts();
+    [[nodiscard]] const std::vector<Contact>& getContacts() const;
     unsigned int size() const;
-    [[nodiscard]] Contact* getContact(int id);
-    [[nodiscard]] Contacts searchByName(const std::string& name);
-    [[nodiscard]] Contacts searchByCompany(const std::string& company);
+    void reserve(std::size_t count);
+    [[nodiscard]] const Contact* getContact(int id) const;
+    [[nodiscard]] View<Contact> searchByName(const std::string& name) const;
+    [[nodiscard]] View<Contact> searchByCompany(const std::string& company) const;
+    [[nodiscard]] std::vector<int> search(const std::string& text, unsigned int fields=TrigramIndex::ALL) const;
 
     void sortByDate(bool reverse=false);
     void sortByName(bool reverse=false);
 
-    [[nodiscard]] Todos getTodosBetween(Date to, Date from);
-    [[nodiscard]] Todos getUrgentTodos();
-    [[nodiscard]] Interactions getInteractionsBetween(Date to, Date from);
-    [[nodiscard]] Interactions getUrgentInteractions();
+    [[nodiscard]] View<Todo> getAllTodos() const;
+    [[nodiscard]] View<Todo> getTodosBetween(Date to, Date from) const;
+    [[nodiscard]] View<Todo> getUrgentTodos() const;
+    [[nodiscard]] View<Interaction> getAllInteractions() const;
+    [[nodiscard]] View<Interaction> getInteractionsBetween(Date to, Date from) const;
+    [[nodiscard]] View<Interaction> getUrgentInteractions() const;
 
     void remove(int id);
 
     void clear();
 
-    Interactions getInteractionsSortedByDate(bool reverse=false);
-    Todos getTodosSortedByDate(bool reverse=false);
+    [[nodiscard]] View<Interaction> getInteractionsSortedByDate(bool reverse=false) const;
+    [[nodiscard]] View<Todo> getTodosSortedByDate(bool reverse=false) const;
 
     // Iterator
-    using iterator = std::list<Contact>::iterator;
-    using const_iterator = std::list<Contact>::const_iterator;
+    using const_iterator = std::vector<Contact>::const_iterator;
 
-    iterator begin();
     const_iterator begin() const;
-    iterator end();
     const_iterator end() const;
 
     friend std::ostream& operator<<(std::ostream& os, const Contacts& c);
 
     // Constructeurs et destructeur
     Contacts();
-    explicit Contacts(std::list<Contact> c);
+    explicit Contacts(std::vector<Contact> c);
     explicit Contacts(const Contact& c);
     ~Contacts();
 
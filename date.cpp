@@ -3,7 +3,7 @@
  *
  * @brief Définition de la classe Date (Gestion simplifiée des dates)
  *
- * @version 1.0
+ * @version 1.1
  *
  * @date 15/10/2021
  *
@@ -12,15 +12,66 @@
  */
 
 #include "date.h"
+#include "timezone.h"
+#include <algorithm>
+
+/**
+ * Noms des jours de la semaine (commençant le Dimanche)
+ */
+static constexpr std::string_view DAY_NAMES[] = {
+        "Dimanche", "Lundi", "Mardi", "Mercredi",
+        "Jeudi", "Vendredi", "Samedi"
+};
+
+/**
+ * Noms des mois de l'année (commençant en Janvier), encodés en UTF-8
+ */
+static constexpr std::string_view MONTH_NAMES[] = {
+        "Janvier", "Février", "Mars", "Avril", "Mai", "Juin", "Juillet", "Aout",
+        "Septembre", "Octobre", "Novembre", "Décembre"
+};
+
+/**
+ * Écrit un nombre sur un nombre fixe de chiffres (complété par des 0).
+ * @param buffer Tampon où écrire
+ * @param value Nombre à écrire
+ * @param width Nombre de chiffres
+ * @return Pointeur juste après le dernier caractère écrit
+ */
+static char* writeDigits(char* buffer, unsigned int value, std::size_t width) {
+    for(std::size_t i = width; i > 0; i--) {
+        buffer[i - 1] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    }
+    return buffer + width;
+}
 
 /**
  * Renvoie la date en lettres.
  * @return Date en lettres en string. (Exemple: Vendredi 15 octobre 2021)
  */
 std::string Date::getDateString() const {
-    std::string date = getDayString() + " " + std::to_string(getDay()) + " "
-            + getMonthString() + " " + std::to_string(getYear());
-    return date;
+    char buffer[DATE_STRING_MAX_SIZE];
+    return std::string(buffer, writeDateString(buffer));
+}
+
+/**
+ * Écrit la date en lettres dans un tampon fourni par l'appelant, sans allocation.
+ * @param buffer Tampon d'au moins DATE_STRING_MAX_SIZE caractères (non terminé par '\0')
+ * @return Pointeur juste après le dernier caractère écrit (Exemple: Vendredi 15 Octobre 2021)
+ */
+char* Date::writeDateString(char* buffer) const {
+    const Civil civil = getCivil();
+    const std::string_view day = DAY_NAMES[getWeekDay()];
+    const std::string_view month = MONTH_NAMES[civil.month - 1];
+
+    buffer = std::copy(day.begin(), day.end(), buffer);
+    *buffer++ = ' ';
+    buffer = civil.day < 10 ? writeDigits(buffer, civil.day, 1) : writeDigits(buffer, civil.day, 2);
+    *buffer++ = ' ';
+    buffer = std::copy(month.begin(), month.end(), buffer);
+    *buffer++ = ' ';
+    return writeDigits(buffer, static_cast<unsigned int>(civil.year), 4);
 }
 
 /**
@@ -28,15 +79,24 @@ std::string Date::getDateString() const {
  * @return L'année représentée par la date (Exemple: 2021)
  */
 unsigned int Date::getYear() const {
-    return 1900 + this->tm.tm_year;
+    return static_cast<unsigned int>(getCivil().year);
+}
+
+/**
+ * Retourne le jour du mois
+ * @return Jour du mois [1; 31]
+ */
+unsigned int Date::getDay() const {
+    return getCivil().day;
 }
 
 /**
  * Retourne l'index du jour en fonction de la semaine (commençant le Dimanche)
+ * Le 01/01/1970 était un jeudi (index 4).
  * @return index du jour [0; 6]
  */
-unsigned int Date::getDay() const {
-    return this->tm.tm_mday;
+unsigned int Date::getWeekDay() const {
+    return static_cast<unsigned int>((getDays() % 7 + 11) % 7);
 }
 
 /**
@@ -44,7 +104,7 @@ unsigned int Date::getDay() const {
  * @return index du mois [0; 11]
  */
 unsigned Date::getMonth() const {
-    return this->tm.tm_mon;
+    return getCivil().month - 1;
 }
 
 /**
@@ -52,13 +112,8 @@ unsigned Date::getMonth() const {
  * @return Jour de la semaine (Exemple: Lundi)
  *
  */
-std::string Date::getDayString() const {
-    std::string days[] = {
-            "Dimanche", "Lundi", "Mardi", "Mercredi",
-            "Jeudi", "Vendredi", "Samedi"
-    };
-
-    return days[this->tm.tm_wday]; // No index verification, we trust in C++
+std::string_view Date::getDayString() const {
+    return DAY_NAMES[getWeekDay()]; // No index verification, we trust in C++
 }
 
 /**
@@ -66,12 +121,8 @@ std::string Date::getDayString() const {
  * @return Mois de l'année (Exemple: Janvier)
  *
  */
-std::string Date::getMonthString() const {
-    std::string months[] = {
-            "Janvier", "Février", "Mars", "Avril", "Mai", "Juin", "Juillet", "Aout",
-            "Septembre", "Octobre", "Novembre", "Décembre"
-    };
-    return months[getMonth()]; // No index verification, we trust in C++
+std::string_view Date::getMonthString() const {
+    return MONTH_NAMES[getMonth()]; // No index verification, we trust in C++
 }
 
 /**
@@ -80,14 +131,22 @@ std::string Date::getMonthString() const {
  * @return Date au format SQLite (yyyy-mm-dd)
  */
 std::string Date::getSqlFormat() const {
+    char buffer[SQL_FORMAT_SIZE];
+    return std::string(buffer, writeSqlFormat(buffer)); // Short string: no allocation
+}
 
-    std::string day = std::string(2 - std::to_string(getDay()).length(), '0') // Complete with 0
-            + std::to_string(getDay()); // Add Day
-    std::string month = std::string(2 - std::to_string(getMonth()+1).length(), '0')  // complete with 0
-            + std::to_string(getMonth()+1); // Add Month
-
-    std::string date = std::to_string(getYear()) + "-" + month+"-" + day;
-    return date;
+/**
+ * Écrit la date au format SQLite (yyyy-mm-dd) dans un tampon fourni par l'appelant, sans allocation.
+ * @param buffer Tampon d'au moins SQL_FORMAT_SIZE caractères (non terminé par '\0')
+ * @return Pointeur juste après le dernier caractère écrit
+ */
+char* Date::writeSqlFormat(char* buffer) const {
+    const Civil civil = getCivil();
+    buffer = writeDigits(buffer, static_cast<unsigned int>(civil.year), 4);
+    *buffer++ = '-';
+    buffer = writeDigits(buffer, civil.month, 2);
+    *buffer++ = '-';
+    return writeDigits(buffer, civil.day, 2);
 }
 
 /**
@@ -96,11 +155,22 @@ std::string Date::getSqlFormat() const {
  *
  */
 std::string Date::getDateCompactString() const {
-    std::string day = std::string(2 - std::to_string(getDay()).length(), '0') // Complete with 0
-            + std::to_string(getDay()); // Add Day
-    std::string month = std::string(2 - std::to_string(getMonth()+1).length(), '0')  // complete with 0
-            + std::to_string(getMonth()+1); // Add Month
-    return day + "/" + month + + "/" + std::to_string(getYear());
+    char buffer[COMPACT_STRING_SIZE];
+    return std::string(buffer, writeDateCompactString(buffer)); // Short string: no allocation
+}
+
+/**
+ * Écrit la date au format compact (dd/mm/yyyy) dans un tampon fourni par l'appelant, sans allocation.
+ * @param buffer Tampon d'au moins COMPACT_STRING_SIZE caractères (non terminé par '\0')
+ * @return Pointeur juste après le dernier caractère écrit
+ */
+char* Date::writeDateCompactString(char* buffer) const {
+    const Civil civil = getCivil();
+    buffer = writeDigits(buffer, civil.day, 2);
+    *buffer++ = '/';
+    buffer = writeDigits(buffer, civil.month, 2);
+    *buffer++ = '/';
+    return writeDigits(buffer, static_cast<unsigned int>(civil.year), 4);
 }
 
 
@@ -109,7 +179,7 @@ std::string Date::getDateCompactString() const {
  * @return Nombre d'heures
  */
 unsigned int Date::getHour() const {
-    return this->tm.tm_hour;
+    return static_cast<unsigned int>(getSecondsOfDay() / 3600);
 }
 
 /**
@@ -117,15 +187,27 @@ unsigned int Date::getHour() const {
  * @return Nombre de minutes
  */
 unsigned int Date::getMinute() const {
-    return this->tm.tm_min;
+    return static_cast<unsigned int>(getSecondsOfDay() % 3600 / 60);
+}
+
+/**
+ * Renvoie la représentation de la date modélisée en nombre de secondes depuis le 1er janvier 1970 (UTC)
+ * @note Passe par le fuseau horaire de la machine, préférer getEpoch() pour comparer ou trier des dates.
+ * @return Nombre de secondes depuis le 01/01/1970 (-1 si la date est invalide)
+ */
+time_t Date::getTotalSeconds() const {
+    if(!isValid())
+        return -1;
+    return TimeZone::toUtc(this->seconds);
 }
 
 /**
- * Renvoie la représentation de la date modélisée en nombre de secondes depuis le 1er janvier 1970
- * @return Nombre de secondes depuis le 01/01/1970
+ * Renvoie la représentation interne de la date: nombre de secondes (heure locale) depuis le 01/01/1970 00:00.
+ * Deux dates se comparent directement avec cette valeur.
+ * @return Secondes locales depuis le 01/01/1970
  */
-time_t Date::getTotalSeconds() {
-    return std::mktime(&this->tm);
+std::int64_t Date::getEpoch() const {
+    return this->seconds;
 }
 
 /**
@@ -134,8 +216,7 @@ time_t Date::getTotalSeconds() {
  */
 bool Date::isValid() const
 {
-    return !(tm.tm_year == 0 && tm.tm_mon == 0 && tm.tm_mday == 0
-            && tm.tm_hour == 0 && tm.tm_min == 0 && tm.tm_sec == 0);
+    return seconds != INVALID;
 }
 
 /**
@@ -143,9 +224,7 @@ bool Date::isValid() const
  * @param seconds Nombre de secondes depuis le 1er janvier 1970.
  */
 void Date::setDate(time_t seconds) {
-    //Unsecure
-    this->tm = *localtime(&seconds);
-    //localtime_s(&this->tm, &s); <-- Better
+    this->seconds = TimeZone::toLocal(seconds); // Reentrant (see TimeZone)
 }
 
 /**
@@ -156,9 +235,7 @@ void Date::setDate(time_t seconds) {
  * @return Si les dates sont égales
  */
 bool operator==(const Date& a, const Date& b) {
-    Date a1 = a; // Copy because mktime() cannot be const
-    Date b1 = b;
-    return a1.getTotalSeconds() == b1.getTotalSeconds();
+    return a.seconds == b.seconds;
 }
 
 /**
@@ -180,9 +257,7 @@ bool operator!=(const Date& a, const Date& b) {
  * @return Si la date a est plus ancienne que la date b
  */
 bool operator<(const Date& a, const Date& b) {
-    Date a1 = a;
-    Date a2 = b;
-    return a1.getTotalSeconds() < a2.getTotalSeconds();
+    return a.seconds < b.seconds;
 }
 
 /**
@@ -193,9 +268,7 @@ bool operator<(const Date& a, const Date& b) {
  * @return Si la date a est plus récente que la date b
  */
 bool operator>(const Date& a, const Date& b) {
-    Date a1 = a;
-    Date a2 = b;
-    return a1.getTotalSeconds() > a2.getTotalSeconds();
+    return a.seconds > b.seconds;
 }
 
 /**
@@ -206,7 +279,7 @@ bool operator>(const Date& a, const Date& b) {
  * @return Si la date a est plus récente que la date b (ou égale)
  */
 bool operator>=(const Date& a, const Date& b) {
-    return (a > b) || (a == b);
+    return a.seconds >= b.seconds;
 }
 
 /**
@@ -217,7 +290,7 @@ bool operator>=(const Date& a, const Date& b) {
  * @return Si la date a est plus ancienne que la date b (ou égale)
  */
 bool operator<=(const Date& a, const Date& b) {
-    return (a < b) || (a == b);
+    return a.seconds <= b.seconds;
 }
 
 /**
@@ -225,10 +298,7 @@ bool operator<=(const Date& a, const Date& b) {
  * La date est initialisée sur la date de la machine.
  */
 Date::Date() {
-    time_t t = time(nullptr);
-    //Unsecure
-    this->tm = *localtime(&t);
-    //localtime_s(&this->tm, &t); <-- Better
+    setDate(time(nullptr));
 }
 
 /**
@@ -244,17 +314,86 @@ Date::Date(time_t seconds)
 /**
  * Constructeur de la classe.
  * La date est initialisée en fonction du paramètre sqlTime qui doit être de la forme des dates SqLite: yyyy-mm-dd
+ * Si la chaîne n'est pas une date correcte, la date est invalide (voir isValid()).
  * @param sqlTime Date de la forme yyyy-mm-dd
- * @param useHyphen Utiliser le langage courant (jour/mois/année
+ * @param naturalLanguage Utiliser le langage courant (jour/mois/année)
+ */
+Date::Date(std::string_view sqlTime, bool naturalLanguage) {
+    if(!parse(sqlTime, naturalLanguage, this->seconds))
+        this->seconds = INVALID;
+}
+
+/**
+ * Lit une date de la forme yyyy-mm-dd (ou dd/mm/yyyy en langage courant) en une seule passe.
+ * Les chiffres, les séparateurs et les bornes du jour et du mois sont vérifiés. Les caractères au-delà des 10
+ * premiers sont ignorés. Aucune allocation ni locale n'est utilisée.
+ * @param str Chaîne à lire
+ * @param naturalLanguage Format jour/mois/année
+ * @param epoch Représentation interne de la date lue (inchangée en cas d'échec)
+ * @return Si la chaîne est une date correcte
  */
-Date::Date(std::string &sqlTime, bool naturalLanguage) {
-    std::istringstream ss(sqlTime);
-    if(naturalLanguage)
-        ss >> std::get_time(&this->tm, "%d/%m/%Y");
-    else
-        ss >> std::get_time(&this->tm, "%Y-%m-%d");
+bool Date::parse(std::string_view str, bool naturalLanguage, std::int64_t& epoch) {
+    if(str.size() < 10)
+        return false;
+
+    // Position of each field and of both separators
+    const std::size_t yearPos = naturalLanguage ? 6 : 0;
+    const std::size_t monthPos = naturalLanguage ? 3 : 5;
+    const std::size_t dayPos = naturalLanguage ? 0 : 8;
+    const char separator = naturalLanguage ? '/' : '-';
+    const std::size_t firstSeparator = naturalLanguage ? 2 : 4;
+
+    if(str[firstSeparator] != separator || str[firstSeparator + 3] != separator)
+        return false;
+
+    auto digits = [&str](std::size_t pos, std::size_t count, unsigned int& value) {
+        value = 0;
+        for(std::size_t i = pos; i < pos + count; i++) {
+            const unsigned int digit = static_cast<unsigned char>(str[i]) - '0';
+            if(digit > 9)
+                return false;
+            value = value * 10 + digit;
+        }
+        return true;
+    };
+
+    unsigned int year, month, day;
+    if(!digits(yearPos, 4, year) || !digits(monthPos, 2, month) || !digits(dayPos, 2, day))
+        return false;
+
+    if(month < 1 || month > 12 || day < 1 || day > daysInMonth(year, month))
+        return false;
+
+    epoch = daysFromCivil(year, month, day) * SECONDS_PER_DAY;
+    return true;
 }
 
+/**
+ * Lit une colonne entière de dates dans un tableau déjà alloué.
+ * Les chaînes incorrectes donnent une date invalide (voir isValid()).
+ * @param strings Tableau de chaînes à lire
+ * @param count Nombre de chaînes
+ * @param out Tableau d'au moins count dates où écrire le résultat
+ * @param naturalLanguage Format jour/mois/année
+ * @return Nombre de dates valides lues
+ */
+std::size_t Date::parseAll(const std::string_view* strings, std::size_t count, Date* out, bool naturalLanguage) {
+    std::size_t valid = 0;
+    for(std::size_t i = 0; i < count; i++) {
+        if(parse(strings[i], naturalLanguage, out[i].seconds))
+            valid++;
+        else
+            out[i].seconds = INVALID;
+    }
+    return valid;
+}
+
+/**
+ * Constructeur privé à partir de la représentation interne.
+ * @param epoch Secondes locales depuis le 01/01/1970 00:00
+ */
+Date::Date(EpochTag, std::int64_t epoch) : seconds(epoch) {}
+
 /**
  * Surcharge de l'opérateur <<
  * @param os Stream de sortie
@@ -262,9 +401,9 @@ Date::Date(std::string &sqlTime, bool naturalLanguage) {
  * @return Représentation textuelle de l'objet
  */
 std::ostream &operator<<(std::ostream &os, const Date &i) {
-    const Date& i1 = i;
+    char buffer[Date::COMPACT_STRING_SIZE];
     os << "Date(";
-    os << i1.getDateCompactString();
+    os.write(buffer, i.writeDateCompactString(buffer) - buffer);
     os << ")";
     return os;
 }
@@ -273,3 +412,23 @@ std::ostream &operator<<(std::ostream &os, const Date &i) {
  * Destructeur par défaut (géré par le compilateur).
  */
 Date::~Date() = default;
+
+/**
+ * Crée une date à partir de sa représentation interne (voir getEpoch()).
+ * @param epoch Secondes locales depuis le 01/01/1970 00:00
+ * @return Date correspondante
+ */
+Date Date::fromEpoch(std::int64_t epoch) {
+    return Date(EpochTag{}, epoch);
+}
+
+/**
+ * Crée une date à minuit à partir des champs du calendrier.
+ * @param year Année (Exemple: 2021)
+ * @param month Mois [1; 12]
+ * @param day Jour du mois [1; 31]
+ * @return Date correspondante
+ */
+Date Date::fromCivil(int year, unsigned int month, unsigned int day) {
+    return fromEpoch(daysFromCivil(year, month, day) * SECONDS_PER_DAY);
+}
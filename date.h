@@ -3,7 +3,7 @@
  *
  * @brief Déclaration de la classe Date (Gestion simplifiée des dates)
  *
- * @version 1.0
+ * @version 1.1
  *
  * @date 15/10/2021
  *
@@ -15,7 +15,10 @@
 #define CDAA_DATE_H
 
 #include <ctime>
+#include <cstdint>
+#include <limits>
 #include <string>
+#include <string_view>
 #include <iostream>
 #include <iomanip>
 #include <sstream>
@@ -23,28 +26,66 @@
 
 /**
  * Classe permettant de gérer plus facilement les dates.
- * L'ensemble des accesseurs sont virtuels. La structure tm n'est pas modifiable directement.
+ * La date est stockée sous la forme d'un nombre de secondes (heure locale) écoulées depuis le 01/01/1970 00:00.
+ * Les champs du calendrier (jour, mois, année...) sont calculés à la demande, les comparaisons sont de simples
+ * comparaisons d'entiers.
+ * La classe n'utilise aucun état partagé modifiable (voir TimeZone) : elle peut être utilisée depuis plusieurs threads.
+ * Les méthodes write...() écrivent la date dans un tampon fourni par l'appelant, sans aucune allocation.
  * \brief Classe permettant une gestion simplifiée des dates
  */
 class Date {
 private:
-    struct tm tm{}; /*!< Structure tm qui stock la date. */
+    std::int64_t seconds; /*!< Secondes (heure locale) depuis le 01/01/1970 00:00, INVALID si la date est invalide. */
+
+    static constexpr std::int64_t INVALID = std::numeric_limits<std::int64_t>::min(); /*!< Valeur d'une date invalide */
+    static constexpr std::int64_t SECONDS_PER_DAY = 86400; /*!< Nombre de secondes dans une journée */
+
+    /**
+     * Date du calendrier grégorien (mois et jour commencent à 1)
+     */
+    struct Civil {
+        std::int64_t year; /*!< Année (Exemple: 2021) */
+        unsigned int month; /*!< Mois [1; 12] */
+        unsigned int day; /*!< Jour du mois [1; 31] */
+    };
+
+    static constexpr std::int64_t daysFromCivil(std::int64_t year, unsigned int month, unsigned int day);
+    static constexpr Civil civilFromDays(std::int64_t days);
+    static constexpr unsigned int daysInMonth(std::int64_t year, unsigned int month);
+    static bool parse(std::string_view str, bool naturalLanguage, std::int64_t& epoch);
+
+    [[nodiscard]] constexpr std::int64_t getDays() const;
+    [[nodiscard]] constexpr std::int64_t getSecondsOfDay() const;
+    [[nodiscard]] constexpr Civil getCivil() const;
+
+    struct EpochTag {}; /*!< Sélectionne le constructeur à partir de la représentation interne */
+    Date(EpochTag, std::int64_t epoch);
 
     // Voir Date.cpp pour la documentation des méthodes
 public:
+    static constexpr std::size_t SQL_FORMAT_SIZE = 10; /*!< Taille du format SQLite (yyyy-mm-dd) */
+    static constexpr std::size_t COMPACT_STRING_SIZE = 10; /*!< Taille du format compact (dd/mm/yyyy) */
+    static constexpr std::size_t DATE_STRING_MAX_SIZE = 32; /*!< Taille maximale de la date en lettres (UTF-8) */
+
     [[nodiscard]] std::string getDateString() const;
     [[nodiscard]] std::string getDateCompactString() const;
-    [[nodiscard]] std::string getDayString() const;
-    [[nodiscard]] std::string getMonthString() const;
+    [[nodiscard]] std::string_view getDayString() const;
+    [[nodiscard]] std::string_view getMonthString() const;
     [[nodiscard]] std::string getSqlFormat() const;
 
+    char* writeDateString(char* buffer) const;
+    char* writeDateCompactString(char* buffer) const;
+    char* writeSqlFormat(char* buffer) const;
+
     [[nodiscard]] unsigned int getYear() const;
     [[nodiscard]] unsigned int getDay() const;
+    [[nodiscard]] unsigned int getWeekDay() const;
     [[nodiscard]] unsigned int getMonth() const;
     [[nodiscard]] unsigned int getHour() const;
     [[nodiscard]] unsigned int getMinute() const;
 
-    [[nodiscard]] time_t getTotalSeconds();
+    [[nodiscard]] time_t getTotalSeconds() const;
+    [[nodiscard]] std::int64_t getEpoch() const;
 
     [[nodiscard]] bool isValid() const;
 
@@ -63,9 +104,88 @@ public:
     // Constructeurs et destructeur
     Date();
     explicit Date(time_t seconds);
-    explicit Date(std::string& sqlTime, bool naturalLanguage=false);
+    explicit Date(std::string_view sqlTime, bool naturalLanguage=false);
     ~Date();
+
+    static Date fromEpoch(std::int64_t epoch);
+    static Date fromCivil(int year, unsigned int month, unsigned int day);
+    static std::size_t parseAll(const std::string_view* strings, std::size_t count, Date* out,
+                                bool naturalLanguage=false);
 };
 
+/**
+ * Nombre de jours entre le 01/01/1970 et la date du calendrier donnée (algorithme de H. Hinnant).
+ * @param year Année
+ * @param month Mois [1; 12]
+ * @param day Jour du mois [1; 31]
+ * @return Nombre de jours depuis le 01/01/1970 (négatif avant)
+ */
+constexpr std::int64_t Date::daysFromCivil(std::int64_t year, unsigned int month, unsigned int day)
+{
+    year -= month <= 2;
+    const std::int64_t era = (year >= 0 ? year : year - 399) / 400;
+    const auto yoe = static_cast<unsigned int>(year - era * 400);                     // [0, 399]
+    const unsigned int doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1; // [0, 365]
+    const unsigned int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;                   // [0, 146096]
+    return era * 146097 + static_cast<std::int64_t>(doe) - 719468;
+}
+
+/**
+ * Date du calendrier correspondant à un nombre de jours depuis le 01/01/1970 (algorithme de H. Hinnant).
+ * @param days Nombre de jours depuis le 01/01/1970
+ * @return Date du calendrier
+ */
+constexpr Date::Civil Date::civilFromDays(std::int64_t days)
+{
+    days += 719468;
+    const std::int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+    const auto doe = static_cast<unsigned int>(days - era * 146097);              // [0, 146096]
+    const unsigned int yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365; // [0, 399]
+    const unsigned int doy = doe - (365 * yoe + yoe / 4 - yoe / 100);             // [0, 365]
+    const unsigned int mp = (5 * doy + 2) / 153;                                  // [0, 11]
+    const unsigned int month = mp < 10 ? mp + 3 : mp - 9;
+    return { static_cast<std::int64_t>(yoe) + era * 400 + (month <= 2), month, doy - (153 * mp + 2) / 5 + 1 };
+}
+
+/**
+ * Nombre de jours dans un mois du calendrier grégorien.
+ * @param year Année
+ * @param month Mois [1; 12]
+ * @return Nombre de jours du mois [28; 31]
+ */
+constexpr unsigned int Date::daysInMonth(std::int64_t year, unsigned int month)
+{
+    if(month == 2)
+        return (year % 4 == 0 && (year % 100 != 0 || year % 400 == 0)) ? 29 : 28;
+    return (month == 4 || month == 6 || month == 9 || month == 11) ? 30 : 31;
+}
+
+/**
+ * Nombre de jours entiers écoulés depuis le 01/01/1970 (arrondi vers le bas).
+ * @return Nombre de jours
+ */
+constexpr std::int64_t Date::getDays() const
+{
+    return seconds / SECONDS_PER_DAY - (seconds % SECONDS_PER_DAY < 0);
+}
+
+/**
+ * Nombre de secondes écoulées depuis le début de la journée.
+ * @return Secondes [0; 86399]
+ */
+constexpr std::int64_t Date::getSecondsOfDay() const
+{
+    const std::int64_t rest = seconds % SECONDS_PER_DAY;
+    return rest < 0 ? rest + SECONDS_PER_DAY : rest;
+}
+
+/**
+ * Date du calendrier représentée.
+ * @return Date du calendrier
+ */
+constexpr Date::Civil Date::getCivil() const
+{
+    return civilFromDays(getDays());
+}
 
 #endif //CDAA_DATE_H
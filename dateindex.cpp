@@ -0,0 +1,124 @@
+/**
+ * @file dateindex.cpp
+ *
+ * @brief Définition de la classe DateIndex (index chronologique d'identifiants)
+ *
+ * @version 1.0
+ *
+ * @author LEESTMANS Richard
+ * @author COUDERT Nicolas
+ */
+
+#include "dateindex.h"
+#include <limits>
+
+/**
+ * Compare deux éléments de l'index (par date, puis par identifiant)
+ * @param a Premier élément
+ * @param b Second élément
+ * @return Si a se place avant b
+ */
+bool DateIndex::Before::operator()(const Entry& a, const Entry& b) const
+{
+    return a.epoch < b.epoch || (a.epoch == b.epoch && a.id < b.id);
+}
+
+/**
+ * Compare deux éléments de l'index dans l'ordre inverse (du plus récent au plus ancien)
+ * @param a Premier élément
+ * @param b Second élément
+ * @return Si a se place après b dans l'index
+ */
+bool DateIndex::After::operator()(const Entry& a, const Entry& b) const
+{
+    return Before()(b, a);
+}
+
+/**
+ * Ajoute un élément daté à l'index (ne fait rien s'il y est déjà)
+ * @param epoch Date de l'élément (Date::getEpoch())
+ * @param id Identifiant de l'élément
+ */
+void DateIndex::insert(std::int64_t epoch, int id)
+{
+    // Elements are often added in chronological order: hint at the end
+    this->entries.insert(this->entries.end(), { epoch, id });
+}
+
+/**
+ * Retire un élément daté de l'index (ne fait rien s'il n'y est pas)
+ * @param epoch Date sous laquelle l'élément a été ajouté
+ * @param id Identifiant de l'élément
+ */
+void DateIndex::erase(std::int64_t epoch, int id)
+{
+    this->entries.erase({ epoch, id });
+}
+
+/**
+ * Vide l'index
+ */
+void DateIndex::clear()
+{
+    this->entries.clear();
+}
+
+/**
+ * Renvoie le nombre d'éléments de l'index
+ * @return Nombre d'éléments
+ */
+std::size_t DateIndex::size() const
+{
+    return this->entries.size();
+}
+
+/**
+ * Indique si l'index est vide
+ * @return Si l'index ne contient aucun élément
+ */
+bool DateIndex::empty() const
+{
+    return this->entries.empty();
+}
+
+/**
+ * Renvoie tous les éléments de l'index, par ordre chronologique
+ * @return Intervalle couvrant tout l'index
+ */
+DateIndex::Range DateIndex::all() const
+{
+    return { this->entries.begin(), this->entries.end() };
+}
+
+/**
+ * Renvoie un intervalle vide (pour une recherche sans résultat)
+ * @return Intervalle vide
+ */
+DateIndex::Range DateIndex::none() const
+{
+    return { this->entries.end(), this->entries.end() };
+}
+
+/**
+ * Renvoie les éléments datés entre deux bornes incluses, par ordre chronologique (O(log n))
+ * @param from Date de début (Date::getEpoch())
+ * @param to Date de fin (Date::getEpoch())
+ * @return Intervalle des éléments concernés (vide si from > to)
+ */
+DateIndex::Range DateIndex::between(std::int64_t from, std::int64_t to) const
+{
+    if(from > to)
+        return none();
+    return { this->entries.lower_bound({ from, std::numeric_limits<int>::min() }),
+             this->entries.upper_bound({ to, std::numeric_limits<int>::max() }) };
+}
+
+/**
+ * Renvoie un intervalle de l'index parcouru à l'envers (du plus récent au plus ancien)
+ * @param range Intervalle de l'index
+ * @return Mêmes éléments, dans l'ordre inverse
+ */
+DateIndex::ReverseRange DateIndex::reverse(const Range& range)
+{
+    return { std::make_reverse_iterator(range.second), std::make_reverse_iterator(range.first) };
+}
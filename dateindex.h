@@ -0,0 +1,78 @@
+/**
+ * @file dateindex.h
+ *
+ * @brief Déclaration de la classe DateIndex (index chronologique d'identifiants)
+ *
+ * @author LEESTMANS Richard
+ * @author COUDERT Nicolas
+ */
+
+#ifndef CDAA_DATEINDEX_H
+#define CDAA_DATEINDEX_H
+
+#include <cstdint>
+#include <iterator>
+#include <set>
+#include <utility>
+
+/**
+ * Index ordonné de couples (date, identifiant), utilisé par Todos et Interactions pour répondre aux recherches
+ * entre deux dates en O(log n + k) au lieu de parcourir toute la liste.
+ * Les dates sont représentées par leur valeur interne (Date::getEpoch()) : les comparaisons sont de simples
+ * comparaisons d'entiers. À date égale, les identifiants sont classés par ordre croissant.
+ * Les itérateurs restent valides tant que l'élément qu'ils désignent n'est pas retiré.
+ * \brief Index chronologique d'identifiants
+ */
+class DateIndex
+{
+public:
+    /**
+     * Élément de l'index
+     */
+    struct Entry
+    {
+        std::int64_t epoch; /*!< Date (Date::getEpoch()) */
+        int id; /*!< Identifiant de l'élément daté */
+    };
+
+    /**
+     * Ordre de l'index : par date puis par identifiant
+     */
+    struct Before
+    {
+        bool operator()(const Entry& a, const Entry& b) const;
+    };
+
+    /**
+     * Ordre inverse de l'index (du plus récent au plus ancien)
+     */
+    struct After
+    {
+        bool operator()(const Entry& a, const Entry& b) const;
+    };
+
+private:
+    std::set<Entry, Before> entries; /*!< Éléments triés par date */
+
+public:
+    using const_iterator = std::set<Entry, Before>::const_iterator;
+    using const_reverse_iterator = std::set<Entry, Before>::const_reverse_iterator;
+    using Range = std::pair<const_iterator, const_iterator>; /*!< Intervalle [first; second[ de l'index */
+    using ReverseRange = std::pair<const_reverse_iterator, const_reverse_iterator>; /*!< Intervalle parcouru à l'envers */
+
+    // Voir dateindex.cpp pour la documentation des méthodes
+    void insert(std::int64_t epoch, int id);
+    void erase(std::int64_t epoch, int id);
+    void clear();
+
+    [[nodiscard]] std::size_t size() const;
+    [[nodiscard]] bool empty() const;
+
+    [[nodiscard]] Range all() const;
+    [[nodiscard]] Range none() const;
+    [[nodiscard]] Range between(std::int64_t from, std::int64_t to) const;
+
+    [[nodiscard]] static ReverseRange reverse(const Range& range);
+};
+
+#endif // CDAA_DATEINDEX_H
@@ -0,0 +1,160 @@
+/**
+ * @file dbexecutor.cpp
+ *
+ * @brief Définition de la classe DBExecutor (thread d'écriture dans la base de données)
+ *
+ * @version 1.0
+ *
+ * @author LEESTMANS Richard
+ * @author COUDERT Nicolas
+ */
+
+#include "dbexecutor.h"
+#include <memory>
+
+/**
+ * Démarre le thread d'écriture (ne fait rien s'il est déjà démarré)
+ * @param databasePath Chemin de la base de données SQLite
+ * @param connectionPragmas Réglages (PRAGMA) à exécuter à l'ouverture de la connexion du thread
+ * @param openFailed Appelé (par le thread d'écriture) si sa connexion ne peut pas être ouverte
+ */
+void DBExecutor::start(const QString& databasePath, const QStringList& connectionPragmas, Failure openFailed)
+{
+    if(this->worker.joinable())
+        return;
+
+    this->path = databasePath;
+    this->pragmas = connectionPragmas;
+    this->failed = std::move(openFailed);
+    this->stopping = false;
+    this->worker = std::thread(&DBExecutor::run, this);
+}
+
+/**
+ * Arrête le thread d'écriture après avoir exécuté tous les travaux en attente
+ */
+void DBExecutor::stop()
+{
+    if(!this->worker.joinable())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->stopping = true;
+    }
+    this->wake.notify_one();
+    this->worker.join();
+}
+
+/**
+ * Indique si le thread d'écriture est démarré
+ * @return Si le thread est démarré
+ */
+bool DBExecutor::isStarted() const
+{
+    return this->worker.joinable();
+}
+
+/**
+ * Soumet un travail au thread d'écriture, sans attendre son exécution.
+ * Les travaux sont exécutés un par un, dans l'ordre de soumission. Si la connexion du thread n'a pas pu être ouverte,
+ * le travail n'est pas exécuté et son résultat est faux.
+ * @param job Travail à exécuter (dans le thread d'écriture)
+ * @return Résultat du travail, disponible une fois qu'il a été exécuté
+ */
+std::future<bool> DBExecutor::submit(Job job)
+{
+    auto result = std::make_shared<std::promise<bool>>();
+    std::future<bool> future = result->get_future();
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->jobs.push_back([this, job = std::move(job), result]() { result->set_value(this->opened && job(*this)); });
+    }
+    this->wake.notify_one();
+    return future;
+}
+
+/**
+ * Renvoie la connexion du thread d'écriture (uniquement depuis un travail)
+ * @return Connexion ouverte
+ */
+QSqlDatabase& DBExecutor::database()
+{
+    return this->connection;
+}
+
+/**
+ * Renvoie une requête préparée sur la connexion du thread (uniquement depuis un travail).
+ * La requête est préparée au premier appel avec ce texte puis réutilisée. En cas d'échec de la préparation, son
+ * exécution échoue et lastError() en donne la raison.
+ * @param sql Texte SQL de la requête
+ * @return Requête préparée, prête à être liée
+ */
+QSqlQuery& DBExecutor::prepared(const QString& sql)
+{
+    auto it = this->statements.find(sql.toStdString());
+    if(it != this->statements.end())
+        return it->second;
+
+    QSqlQuery query(this->connection);
+    query.prepare(sql);
+    return this->statements.emplace(sql.toStdString(), query).first->second;
+}
+
+/**
+ * Boucle du thread d'écriture : ouvre sa connexion puis exécute les travaux jusqu'à l'arrêt (ils échouent tous si
+ * la connexion n'a pas pu être ouverte)
+ */
+void DBExecutor::run()
+{
+    {
+        this->connection = QSqlDatabase::addDatabase("QSQLITE", this->connectionName);
+        this->connection.setDatabaseName(this->path);
+        this->connection.setConnectOptions("QSQLITE_BUSY_TIMEOUT=5000"); // Readers of the GUI thread may hold a lock
+        this->opened = this->connection.open();
+        if(this->opened)
+        {
+            for(const QString& pragma : this->pragmas)
+                QSqlQuery(this->connection).exec(pragma);
+        }
+        else if(this->failed)
+            this->failed(QStringList() << "Ouverture de la base de données impossible (thread d'écriture) !"
+                                       << this->connection.lastError().text());
+
+        std::unique_lock<std::mutex> lock(this->mutex);
+        while(true)
+        {
+            this->wake.wait(lock, [this]() { return this->stopping || !this->jobs.empty(); });
+            if(this->jobs.empty())
+                break; // Stopping, and every job has been executed
+
+            std::function<void()> job = std::move(this->jobs.front());
+            this->jobs.pop_front();
+            lock.unlock();
+            job();
+            lock.lock();
+        }
+        lock.unlock();
+
+        this->statements.clear();
+        this->connection.close();
+        this->connection = QSqlDatabase();
+    }
+    QSqlDatabase::removeDatabase(this->connectionName); // Once no query nor handle uses it anymore
+}
+
+/**
+ * Constructeur du thread d'écriture (le thread est démarré par start)
+ * @param connectionName Nom de la connexion Qt ouverte par le thread
+ */
+DBExecutor::DBExecutor(QString connectionName) : connectionName(std::move(connectionName))
+{
+}
+
+/**
+ * Destructeur : exécute les travaux en attente puis arrête le thread
+ */
+DBExecutor::~DBExecutor()
+{
+    stop();
+}
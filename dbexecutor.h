@@ -0,0 +1,73 @@
+/**
+ * @file dbexecutor.h
+ *
+ * @brief Déclaration de la classe DBExecutor (thread d'écriture dans la base de données)
+ *
+ * @author LEESTMANS Richard
+ * @author COUDERT Nicolas
+ */
+
+#ifndef CDAA_DBEXECUTOR_H
+#define CDAA_DBEXECUTOR_H
+
+#include <QtSql>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+/**
+ * Thread dédié aux écritures dans la base de données SQLite, utilisé par DBInterface.
+ * Le thread possède sa propre connexion (une connexion Qt ne s'utilise que dans le thread qui l'a ouverte) et
+ * exécute dans l'ordre les travaux qui lui sont soumis. L'interface graphique n'attend jamais SQLite : elle soumet un
+ * travail et reçoit un std::future qui contiendra son résultat. Si la connexion du thread ne peut pas être ouverte,
+ * l'erreur est signalée une fois (voir start) et chaque travail échoue immédiatement, sans être exécuté.
+ * Les requêtes préparées par les travaux (voir prepared) sont gardées et réutilisées par le thread.
+ * \brief Thread d'écriture dans la base de données
+ */
+class DBExecutor
+{
+public:
+    using Job = std::function<bool(DBExecutor&)>; /*!< Travail exécuté par le thread (renvoie s'il a réussi) */
+    using Failure = std::function<void(const QStringList&)>; /*!< Signale une erreur (appelé par le thread) */
+
+private:
+    QString path; /*!< Chemin de la base de données */
+    QStringList pragmas; /*!< Réglages exécutés à l'ouverture de la connexion */
+    QString connectionName; /*!< Nom de la connexion du thread */
+    QSqlDatabase connection; /*!< Connexion du thread (utilisée uniquement par le thread) */
+    bool opened = false; /*!< La connexion du thread est ouverte (utilisé uniquement par le thread) */
+    Failure failed; /*!< Appelé une fois si la connexion ne peut pas être ouverte */
+    std::unordered_map<std::string, QSqlQuery> statements; /*!< Requêtes préparées, par texte SQL (utilisées uniquement par le thread) */
+
+    std::thread worker; /*!< Thread d'exécution */
+    std::mutex mutex; /*!< Protège jobs et stopping */
+    std::condition_variable wake; /*!< Signale un nouveau travail ou l'arrêt au thread */
+    std::deque<std::function<void()>> jobs; /*!< Travaux en attente, dans l'ordre de soumission */
+    bool stopping = false; /*!< Le thread doit s'arrêter une fois les travaux terminés */
+
+    void run();
+
+public:
+    // Voir dbexecutor.cpp pour la documentation des méthodes
+    void start(const QString& databasePath, const QStringList& connectionPragmas = QStringList(),
+               Failure openFailed = Failure());
+    void stop();
+    [[nodiscard]] bool isStarted() const;
+
+    std::future<bool> submit(Job job);
+
+    // Only from a job (worker thread)
+    [[nodiscard]] QSqlDatabase& database();
+    [[nodiscard]] QSqlQuery& prepared(const QString& sql);
+
+    explicit DBExecutor(QString connectionName);
+    DBExecutor(const DBExecutor&) = delete;
+    DBExecutor& operator=(const DBExecutor&) = delete;
+    ~DBExecutor();
+};
+
+#endif // CDAA_DBEXECUTOR_H
@@ -16,9 +16,166 @@ bool DBInterface::open()
 {
     if(!db.open())
         criticalError("Ouverture de la base de données impossible");
+    applyProfile();
+    migrate();
+    replayJournal(); // Before anything is read or written
+    // Writes go through their own connection, once the schema is up to date, and reads of whole tables through a
+    // read-only connection of the calling thread
+    writer.start(db.databaseName(), this->profile.getConnectionPragmas(),
+                 [this](const QStringList& errors) { reportError(errors); });
+    readers.setDatabase(db.databaseName(), this->profile.getConnectionPragmas());
     return isOpen();
 }
 
+/**
+ * Applique les réglages du profil de stockage (PRAGMA) à la connexion principale. Le mode du journal obtenu est
+ * affiché : SQLite garde l'ancien mode s'il ne peut pas en changer.
+ */
+void DBInterface::applyProfile()
+{
+    QSqlQuery query(this->db);
+    for(const QString& pragma : this->profile.getPragmas())
+        if(!query.exec(pragma))
+            qDebug() << "Réglage ignoré :" << pragma << query.lastError().text();
+
+    if(query.exec("PRAGMA journal_mode") && query.next())
+        qDebug() << "Profil de stockage" << this->profile.getName() << ": journal" << query.value(0).toString();
+}
+
+/**
+ * Renvoie la version de la structure de la base de données (PRAGMA user_version, 0 pour une ancienne base)
+ * @return Version de la structure
+ */
+int DBInterface::schemaVersion()
+{
+    QSqlQuery query(this->db);
+    if(!query.exec("PRAGMA user_version") || !query.next())
+        return 0;
+    return query.value(0).toInt();
+}
+
+/**
+ * Met à jour la structure d'une base de données existante, sans perte de données.
+ * Les étapes dont le numéro dépasse la version de la base (voir schemaVersion) sont appliquées dans l'ordre, chacune
+ * dans sa propre transaction qui enregistre aussi la nouvelle version : une étape interrompue sera rejouée au
+ * prochain lancement. Une base plus récente que l'application n'est pas modifiée.
+ */
+void DBInterface::migrate()
+{
+    for(int version = schemaVersion(); version < SCHEMA_VERSION; version++)
+    {
+        QSqlQuery query(this->db);
+        if(!this->db.transaction()
+                || !upgradeTo(version + 1, query)
+                || !query.exec("PRAGMA user_version = " + QString::number(version + 1))
+                || !this->db.commit())
+        {
+            QStringList l;
+            l << "Mise à jour de la base de données impossible (version " + QString::number(version + 1) + ") !";
+            l << query.lastError().text();
+            l << query.lastQuery();
+            this->db.rollback();
+            criticalError(l);
+        }
+    }
+}
+
+/**
+ * Applique une étape de mise à jour de la structure
+ * @param version Version atteinte après l'étape (1 à SCHEMA_VERSION)
+ * @param query Requête à utiliser
+ * @return Si la mise à jour a réussi
+ */
+bool DBInterface::upgradeTo(int version, QSqlQuery& query)
+{
+    switch(version)
+    {
+        case 1:
+            return upgradeToVersion1(query);
+        case 2:
+            return upgradeToVersion2(query);
+        case 3:
+            return upgradeToVersion3(query);
+        default:
+            return false;
+    }
+}
+
+/**
+ * Ajoute une colonne à une table si elle n'existe pas encore
+ * @param query Requête à utiliser
+ * @param table Nom de la table
+ * @param column Nom de la colonne
+ * @param definition Type et contraintes de la colonne
+ * @return Si la colonne existe après l'appel
+ */
+bool DBInterface::addColumn(QSqlQuery& query, const QString& table, const QString& column, const QString& definition)
+{
+    if(this->db.record(table).contains(column))
+        return true;
+    return query.exec("ALTER TABLE " + table + " ADD COLUMN " + column + " " + definition);
+}
+
+/**
+ * Version 1 : ajoute la colonne urgent aux tables interaction et todo.
+ * Les anciennes tâches sans date étaient enregistrées au 01/01/1970, elles sont marquées urgentes. Une ancienne
+ * interaction, elle, était urgente si sa date était invalide (voir Interactions::getUrgentInteractions).
+ * @param query Requête à utiliser
+ * @return Si la mise à jour a réussi
+ */
+bool DBInterface::upgradeToVersion1(QSqlQuery& query)
+{
+    static const QString urgentRows[][2] = {
+        { "interaction", "strftime('%s', date) IS NULL" },
+        { "todo", "date='1970-01-01'" }
+    };
+    for(const auto& [table, condition] : urgentRows)
+    {
+        if(this->db.record(table).contains("urgent"))
+            continue;
+
+        if(!addColumn(query, table, "urgent", "INTEGER NOT NULL DEFAULT 0")
+                || !query.exec("UPDATE " + table + " SET urgent=1 WHERE " + condition)
+                || !query.exec("CREATE INDEX IF NOT EXISTS " + table + "_urgent ON " + table + " (owner_id) WHERE urgent=1"))
+            return false;
+    }
+    return true;
+}
+
+/**
+ * Version 2 : ajoute à chaque table une colonne entière contenant sa date (Date::getEpoch(), secondes depuis le
+ * 01/01/1970), remplie à partir des dates texte existantes (NULL si la date texte est invalide).
+ * Les dates texte sont conservées.
+ * @param query Requête à utiliser
+ * @return Si la mise à jour a réussi
+ */
+bool DBInterface::upgradeToVersion2(QSqlQuery& query)
+{
+    // strftime('%s') reads yyyy-mm-dd as midnight, like Date: both give days * 86400
+    return addColumn(query, "interaction", "date_epoch", "INTEGER")
+            && query.exec("UPDATE interaction SET date_epoch=CAST(strftime('%s', date) AS INTEGER)")
+            && addColumn(query, "todo", "date_epoch", "INTEGER")
+            && query.exec("UPDATE todo SET date_epoch=CAST(strftime('%s', date) AS INTEGER)")
+            && addColumn(query, "contact", "creation_epoch", "INTEGER")
+            && query.exec("UPDATE contact SET creation_epoch=CAST(strftime('%s', creation_date) AS INTEGER)");
+}
+
+/**
+ * Version 3 : ajoute les index par propriétaire et par date.
+ * L'index (owner_id, date_epoch) couvre le chargement trié par propriétaire et les recherches de l'historique d'un
+ * contact entre deux dates (l'identifiant fait partie de chaque index SQLite).
+ * @param query Requête à utiliser
+ * @return Si la mise à jour a réussi
+ */
+bool DBInterface::upgradeToVersion3(QSqlQuery& query)
+{
+    return query.exec("CREATE INDEX IF NOT EXISTS interaction_owner_date ON interaction (owner_id, date_epoch)")
+            && query.exec("CREATE INDEX IF NOT EXISTS interaction_date ON interaction (date_epoch)")
+            && query.exec("CREATE INDEX IF NOT EXISTS todo_owner_date ON todo (owner_id, date_epoch)")
+            && query.exec("CREATE INDEX IF NOT EXISTS todo_date ON todo (date_epoch)")
+            && query.exec("CREATE INDEX IF NOT EXISTS contact_creation ON contact (creation_epoch)");
+}
+
 /**
  * Si la connexion est ouverte.
  * @return Connexion ouverte et disponible ?
@@ -29,246 +186,1027 @@ bool DBInterface::isOpen()
 }
 
 /**
- * Renvoie les contacts contenus dans le cache
+ * Renvoie les contacts contenus dans le cache (sans copie)
  * @return Contacts en cache
  */
-Contacts DBInterface::getContacts()
+const Contacts& DBInterface::getContacts() const
 {
     return this->contacts;
 }
 
 /**
- * Renvoie les todos contenus dans le cache
+ * Renvoie les todos contenus dans le cache (sans copie) : celles des contacts dont l'historique a été chargé
+ * (voir loadHistory), ou toutes les tâches une fois les tables en cache (voir whenResident)
  * @return Todos en cache
  */
-Todos DBInterface::getTodos()
+const Todos& DBInterface::getTodos() const
 {
     return this->todos;
 }
 
 /**
- * Renvoie les interactions contenus dans le cache
+ * Renvoie les interactions contenus dans le cache (sans copie) : celles des contacts dont l'historique a été chargé
+ * (voir loadHistory), ou toutes les interactions une fois les tables en cache (voir whenResident)
  * @return Interactions en cache
  */
-Interactions DBInterface::getInteractions()
+const Interactions& DBInterface::getInteractions() const
 {
     return this->interactions;
 }
 
 /**
- * Vide le cache de données de l'interface
+ * Vide le cache de données de l'interface (les opérations en attente sont gardées)
  */
 void DBInterface::clearCache()
 {
     contacts.clear();
     todos.clear();
     interactions.clear();
-    dbTodos.clear();
+    resident = false;
+    histories.clear();
+    recentHistories.clear();
+    historyBytes = 0;
 }
 
 /**
- * Charge l'ensemble des données contenues dans la base.
+ * Charge les contacts contenus dans la base.
+ * Seule la table des contacts est lue : l'historique (interactions et tâches) d'un contact est lu à la première
+ * consultation (voir loadHistory), le temps de démarrage et la mémoire occupée dépendent du nombre de contacts et non
+ * de la taille des historiques. Le temps de chargement est affiché.
+ * Les écritures en attente ne sont pas attendues : les opérations pas encore écrites sont réappliquées sur les
+ * contacts lus (voir overlay).
  * @return Si la lecture s'est bien effectuée
  */
 bool DBInterface::loadData()
 {
-
     clearCache();
 
-    QSqlQuery query;
-    if(!query.exec("SELECT * FROM contact"))
+    if(!loadContacts())
     {
         criticalError("Impossible de charger les tables de la base de données.");
         return false;
     }
 
+    // Identifiers of creations not written yet are not in the database
+    this->lastIds[INTERACTION] = std::max(this->lastIds[INTERACTION], lastId("interaction"));
+    this->lastIds[TODO] = std::max(this->lastIds[TODO], lastId("todo"));
+    this->lastIds[CONTACT] = std::max(this->lastIds[CONTACT], lastId("contact"));
+    return true;
+}
+
+/**
+ * Renvoie le plus grand identifiant déjà attribué dans une table (y compris aux lignes supprimées depuis)
+ * @param table Nom de la table
+ * @return Plus grand identifiant (0 si la table n'a jamais contenu de ligne)
+ */
+int DBInterface::lastId(const QString& table)
+{
+    QSqlQuery query(this->db);
+    int last = 0;
+    if(query.exec("SELECT MAX(id) FROM " + table) && query.next())
+        last = query.value(0).toInt();
+    if(query.exec("SELECT seq FROM sqlite_sequence WHERE name='" + table + "'") && query.next())
+        last = std::max(last, query.value(0).toInt());
+    return last;
+}
+
+/**
+ * Compte les lignes d'une table (pour réserver la place avant le chargement) : seules les lignes déjà écrites sont
+ * comptées, les écritures en attente ne sont pas attendues.
+ * Peut être appelé depuis n'importe quel thread (connexion de lecture du thread, voir ConnectionPool).
+ * @param table Nom de la table
+ * @return Nombre de lignes (0 en cas d'erreur)
+ */
+std::size_t DBInterface::countRows(const QString& table)
+{
+    QSqlQuery query(readers.connection());
+    if(!query.exec("SELECT COUNT(*) FROM " + table) || !query.next())
+        return 0;
+    return query.value(0).toULongLong();
+}
+
+/**
+ * Lit une date chargée depuis la base : la colonne entière si elle est renseignée, la date texte sinon
+ * @param epoch Colonne entière (voir upgradeToVersion2)
+ * @param text Colonne texte (yyyy-mm-dd)
+ * @return Date lue
+ */
+static Date dateOf(const QVariant& epoch, const QVariant& text)
+{
+    if(epoch.isNull())
+        return Date(text.toString().toStdString());
+    return Date::fromEpoch(epoch.toLongLong());
+}
+
+static const QString CONTACT_COLUMNS = "id, first_name, last_name, company, email, phone, creation_date, note, "
+                                       "creation_epoch"; /*!< Colonnes lues par contactOf */
+static const QString INTERACTION_COLUMNS = "id, owner_id, type, description, date, urgent, date_epoch"; /*!< Colonnes lues par interactionOf */
+static const QString TODO_COLUMNS = "id, owner_id, description, date, urgent, date_epoch"; /*!< Colonnes lues par todoOf */
+
+/**
+ * Lit le contact de la ligne courante d'une requête (colonnes CONTACT_COLUMNS)
+ * @param query Requête positionnée sur une ligne
+ * @return Contact lu
+ */
+static Contact contactOf(const QSqlQuery& query)
+{
+    Contact c;
+    c.setId(query.value(0).toInt());
+    c.setFirstName(query.value(1).toString().toStdString());
+    c.setLastName(query.value(2).toString().toStdString());
+    c.setCompany(query.value(3).toString().toStdString());
+    c.setEmail(query.value(4).toString().toStdString());
+    c.setPhone(query.value(5).toString().toStdString());
+    c.setCreationDate(dateOf(query.value(8), query.value(6)));
+    c.setNote(query.value(7).toString().toStdString());
+    return c;
+}
+
+/**
+ * Lit l'interaction de la ligne courante d'une requête (colonnes INTERACTION_COLUMNS)
+ * @param query Requête positionnée sur une ligne
+ * @return Interaction lue
+ */
+static Interaction interactionOf(const QSqlQuery& query)
+{
+    Interaction i;
+    i.setId(query.value(0).toInt());
+    i.setOwnerId(query.value(1).toInt());
+    i.setType(query.value(2).toInt());
+    std::string desc = query.value(3).toString().toStdString();
+    i.setDescription(desc);
+    i.setDate(dateOf(query.value(6), query.value(4)));
+    i.setUrgent(query.value(5).toBool());
+    return i;
+}
+
+/**
+ * Lit la tâche de la ligne courante d'une requête (colonnes TODO_COLUMNS)
+ * @param query Requête positionnée sur une ligne
+ * @return Tâche lue
+ */
+static Todo todoOf(const QSqlQuery& query)
+{
+    Todo t;
+    t.setId(query.value(0).toInt());
+    t.setOwnerId(query.value(1).toInt());
+    std::string desc = query.value(2).toString().toStdString();
+    t.setDescription(desc);
+    t.setDate(dateOf(query.value(5), query.value(3)));
+    t.setUrgent(query.value(4).toBool());
+    return t;
+}
+
+/**
+ * Recopie dans un contact les valeurs d'une opération (voir valuesOf)
+ * @param c Contact à modifier
+ * @param values Valeurs d'une création ou d'une modification
+ */
+static void assign(Contact& c, const QVariantMap& values)
+{
+    c.setId(values.value(":id").toInt());
+    c.setFirstName(values.value(":first_name").toString().toStdString());
+    c.setLastName(values.value(":last_name").toString().toStdString());
+    c.setCompany(values.value(":company").toString().toStdString());
+    c.setEmail(values.value(":email").toString().toStdString());
+    c.setPhone(values.value(":phone").toString().toStdString());
+    c.setCreationDate(dateOf(values.value(":creation_epoch"), values.value(":creation_date")));
+    c.setNote(values.value(":note").toString().toStdString());
+}
+
+/**
+ * Recopie dans une interaction les valeurs d'une opération (voir valuesOf)
+ * @param i Interaction à modifier
+ * @param values Valeurs d'une création ou d'une modification (le propriétaire n'est donné qu'à la création)
+ */
+static void assign(Interaction& i, const QVariantMap& values)
+{
+    i.setId(values.value(":id").toInt());
+    if(values.contains(":owner_id"))
+        i.setOwnerId(values.value(":owner_id").toInt());
+    i.setType(values.value(":type").toInt());
+    std::string desc = values.value(":description").toString().toStdString();
+    i.setDescription(desc);
+    i.setDate(dateOf(values.value(":date_epoch"), values.value(":date")));
+    i.setUrgent(values.value(":urgent").toBool());
+}
+
+/**
+ * Recopie dans une tâche les valeurs d'une opération (voir valuesOf)
+ * @param t Tâche à modifier
+ * @param values Valeurs d'une création ou d'une modification (le propriétaire n'est donné qu'à la création)
+ */
+static void assign(Todo& t, const QVariantMap& values)
+{
+    t.setId(values.value(":id").toInt());
+    if(values.contains(":owner_id"))
+        t.setOwnerId(values.value(":owner_id").toInt());
+    std::string desc = values.value(":description").toString().toStdString();
+    t.setDescription(desc);
+    t.setDate(dateOf(values.value(":date_epoch"), values.value(":date")));
+    t.setUrgent(values.value(":urgent").toBool());
+}
+
+/**
+ * Lecture de tous les contacts, les opérations pas encore écrites sont ensuite réappliquées (voir overlay)
+ * @return Si la lecture s'est bien effectuée
+ */
+bool DBInterface::loadContacts()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    pruneSent();
+    const std::int64_t written = this->writtenSequence.load(); // Before the rows are read
+
+    contacts.reserve(countRows("contact"));
+
+    QSqlQuery query(this->db);
+    query.setForwardOnly(true); // Rows are read once: no need to cache them
+    if(!query.exec("SELECT " + CONTACT_COLUMNS + " FROM contact"))
+        return false;
+
     while(query.next())
+        contacts.addContact(contactOf(query));
+    overlay(written, contacts);
+
+    qDebug() << "contact:" << contacts.size() << "lignes chargées en" << timer.elapsed() << "ms";
+    return true;
+}
+
+/**
+ * Lecture de toutes les interactions écrites dans la base (reliées ou non à un contact), triées par propriétaire.
+ * Les écritures en attente ne sont pas attendues (voir loadResident, qui réapplique les opérations pas encore écrites).
+ * Peut être appelé depuis n'importe quel thread (connexion de lecture du thread, voir ConnectionPool).
+ * @return Toutes les interactions écrites dans la base
+ */
+Interactions DBInterface::loadAllInteractions()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    Interactions all;
+    all.reserve(countRows("interaction"));
+
+    QSqlQuery query(readers.connection());
+    query.setForwardOnly(true); // Rows are read once: no need to cache them
+    if(!query.exec("SELECT " + INTERACTION_COLUMNS + " FROM interaction ORDER BY owner_id, date_epoch"))
     {
-        Contact c;
-        c.setId(query.value(0).toInt());
-        c.setFirstName(query.value(1).toString().toStdString());
-        c.setLastName(query.value(2).toString().toStdString());
-        c.setCompany(query.value(3).toString().toStdString());
-        c.setEmail(query.value(4).toString().toStdString());
-        c.setPhone(query.value(5).toString().toStdString());
-        c.setNote(query.value(7).toString().toStdString());
-
-        std::string sqlDate = query.value(6).toString().toStdString();
-        c.setCreationDate(Date(sqlDate));
-
-        contacts.addContact(c);
+        qDebug() << query.lastError();
+        return all;
     }
 
-    for(auto& c: contacts)
+    while(query.next())
+        all.addInteraction(interactionOf(query));
+
+    qDebug() << "interaction:" << all.size() << "lignes chargées en" << timer.elapsed() << "ms";
+    return all;
+}
+
+/**
+ * Lecture de toutes les todos écrites dans la base, triées par propriétaire.
+ * Les écritures en attente ne sont pas attendues (voir loadResident, qui réapplique les opérations pas encore écrites).
+ * Peut être appelé depuis n'importe quel thread (connexion de lecture du thread, voir ConnectionPool).
+ * @return Toutes les tâches écrites dans la base
+ */
+Todos DBInterface::loadAllTodos()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    Todos all;
+    all.reserve(countRows("todo"));
+
+    QSqlQuery query(readers.connection());
+    query.setForwardOnly(true); // Rows are read once: no need to cache them
+    if(!query.exec("SELECT " + TODO_COLUMNS + " FROM todo ORDER BY owner_id, date_epoch"))
     {
-        loadContactInteractions(c);
-        loadContactTodos(c);
+        qDebug() << query.lastError();
+        return all;
     }
 
-    loadOtherInteractions();
+    while(query.next())
+        all.addTodo(todoOf(query));
 
-    return true;
+    qDebug() << "todo:" << all.size() << "lignes chargées en" << timer.elapsed() << "ms";
+    return all;
 }
 
 /**
- * Lecture des interactions qui ne sont pas reliées à un contact
+ * Appelle ready quand toutes les interactions et toutes les tâches sont en cache (vues globales : rendez-vous,
+ * historique complet, exportation, statistiques).
+ * Les tables ne sont lues qu'à la première demande, par d'autres threads (voir loadResident) : l'interface graphique
+ * n'est pas bloquée et ready est appelé une fois la lecture remise. Elles restent ensuite en cache, tenues à jour par
+ * add, update et remove : les demandes suivantes appellent ready immédiatement.
+ * @param ready Appelé par le thread de l'interface graphique, tables en cache (voir getInteractions, getTodos)
  */
-void DBInterface::loadOtherInteractions()
+void DBInterface::whenResident(std::function<void()> ready)
 {
-    QSqlQuery query;
-    query.prepare("SELECT * FROM interaction WHERE owner_id=-1"); // Using ODBC style
-    if(query.exec())
+    if(this->resident)
     {
-        while(query.next())
-        {
-            Interaction i;
-            i.setId(query.value(0).toInt());
-            i.setOwnerId(query.value(1).toInt());
-            i.setType(query.value(2).toInt());
-            std::string desc = query.value(3).toString().toStdString();
-            i.setDescription(desc);
-            std::string sqlDate = query.value(4).toString().toStdString();
-            Date d(sqlDate);
-            i.setDate(d);
-            interactions.addInteraction(i);
-        }
+        ready();
+        return;
     }
-    else
+
+    this->residentWaiters.push_back(std::move(ready));
+    if(this->residentWaiters.size() == 1) // Not being read yet
+        loadResident();
+}
+
+/**
+ * Indique si toutes les interactions et toutes les tâches sont en cache (voir whenResident)
+ * @return Si les tables sont en cache
+ */
+bool DBInterface::isResident() const
+{
+    return this->resident;
+}
+
+/**
+ * Lit toutes les interactions et toutes les tâches de la base pour les garder en cache, sans bloquer l'interface
+ * graphique.
+ * Les deux tables sont lues en parallèle par d'autres threads (chacun avec sa connexion, voir ConnectionPool), sans
+ * attendre les écritures en attente. Elles sont remises au thread de l'interface graphique (appel mis en file
+ * d'attente) : les opérations pas encore écrites au début de la lecture y sont réappliquées (voir overlay), elles
+ * remplacent le cache des historiques et les appels en attente (voir whenResident) sont faits. Si l'interface est
+ * détruite avant, rien n'est remis.
+ */
+void DBInterface::loadResident()
+{
+    pruneSent();
+    const std::int64_t written = this->writtenSequence.load(); // Before the rows are read
+    this->readMarks.insert(written); // Operations after the mark are kept until the tables are delivered
+
+    auto tables = std::make_shared<std::pair<Interactions, Todos>>();
+    std::weak_ptr<bool> alive = this->alive;
+    auto deliver = [this, tables, written, alive]() {
+        if(alive.expired())
+            return;
+        this->readMarks.erase(this->readMarks.find(written));
+        overlay(written, -1, tables->first, tables->second);
+
+        // Every history is now in cache (not copied: the tables were built by the reading threads)
+        this->interactions.swap(tables->first);
+        this->todos.swap(tables->second);
+        this->histories.clear();
+        this->recentHistories.clear();
+        this->historyBytes = 0;
+        this->resident = true;
+
+        std::vector<std::function<void()>> ready;
+        ready.swap(this->residentWaiters); // A call may ask again
+        for(const auto& call : ready)
+            call();
+    };
+
+    this->wholeReads.push_back(std::async(std::launch::async, [this, tables, deliver]() {
+        std::future<Todos> todosRead = std::async(std::launch::async, [this]() { return loadAllTodos(); });
+        tables->first = loadAllInteractions();
+        tables->second = todosRead.get();
+        QMetaObject::invokeMethod(QCoreApplication::instance(), deliver, Qt::QueuedConnection);
+    }));
+
+    // Forget the reads already delivered
+    this->wholeReads.remove_if([](const std::future<void>& read) {
+        return read.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    });
+}
+
+static constexpr std::size_t INDEX_NODE_SIZE = sizeof(DateIndex::Entry) + 4 * sizeof(void*); /*!< Nœud d'un index (arbre ou table de hachage) */
+
+/**
+ * Estime la mémoire occupée par une interaction en cache (objet, description et nœuds des index)
+ * @param i Interaction
+ * @return Taille estimée en octets
+ */
+static std::size_t footprint(const Interaction& i)
+{
+    return sizeof(Interaction) + i.getDescription().size() + 3 * INDEX_NODE_SIZE; // Id, date and owner indexes
+}
+
+/**
+ * Estime la mémoire occupée par une tâche en cache (objet, description et nœuds des index)
+ * @param t Tâche
+ * @return Taille estimée en octets
+ */
+static std::size_t footprint(const Todo& t)
+{
+    return sizeof(Todo) + t.getDescription().size() + 4 * INDEX_NODE_SIZE; // Id, date, owner and due date indexes
+}
+
+/**
+ * Charge l'historique (interactions et tâches) d'un contact s'il n'est pas déjà en cache.
+ * L'historique est lu par deux requêtes préparées (index par propriétaire de la base) puis gardé en cache. Les
+ * historiques consultés le moins récemment sont retirés du cache quand la mémoire estimée dépasse le budget
+ * (voir setHistoryBudget) ; ils seront relus à la prochaine consultation. Une fois toutes les tables en cache (voir
+ * whenResident), il n'y a rien à lire.
+ * Les écritures en attente ne sont pas attendues : les opérations du contact pas encore écrites sont réappliquées sur
+ * les lignes lues (voir overlay).
+ * @param contactId Identifiant du contact
+ */
+void DBInterface::loadHistory(int contactId)
+{
+    if(this->resident)
+        return;
+
+    auto found = this->histories.find(contactId);
+    if(found != this->histories.end())
     {
-        qDebug() << query.lastError();
+        // Most recently used first
+        this->recentHistories.splice(this->recentHistories.begin(), this->recentHistories, found->second.recent);
+        return;
     }
+
+    pruneSent();
+    const std::int64_t written = this->writtenSequence.load(); // Before the rows are read
+    Interactions is;
+    Todos ts;
+
+    QSqlQuery& interactionQuery = statement(INTERACTION, LOAD);
+    interactionQuery.bindValue(":owner_id", contactId);
+    if(execute(interactionQuery, "Impossible de charger l'historique du contact !"))
+        while(interactionQuery.next())
+            is.addInteraction(interactionOf(interactionQuery));
+    interactionQuery.finish();
+
+    QSqlQuery& todoQuery = statement(TODO, LOAD);
+    todoQuery.bindValue(":owner_id", contactId);
+    if(execute(todoQuery, "Impossible de charger l'historique du contact !"))
+        while(todoQuery.next())
+            ts.addTodo(todoOf(todoQuery));
+    todoQuery.finish();
+
+    overlay(written, contactId, is, ts);
+
+    this->recentHistories.push_front(contactId);
+    this->histories[contactId] = { this->recentHistories.begin(), 0 };
+    for(const Interaction& i : is)
+        cache(i);
+    for(const Todo& t : ts)
+        cache(t);
+
+    evictHistories();
 }
 
 /**
- * Lecture des interactions d'un contact dans la base de données
- * @param c Contact
+ * Définit la mémoire (estimée) que peuvent occuper les historiques en cache.
+ * L'historique consulté en dernier reste toujours en cache, même s'il dépasse le budget à lui seul. Le budget ne
+ * s'applique plus une fois toutes les tables en cache (voir whenResident).
+ * @param bytes Budget en octets
  */
-void DBInterface::loadContactInteractions(Contact& c)
+void DBInterface::setHistoryBudget(std::size_t bytes)
 {
-    QSqlQuery query;
-    query.prepare("SELECT * FROM interaction WHERE owner_id=?"); // Using ODBC style
-    query.bindValue(0, c.getId());
-    if(query.exec())
+    this->historyBudget = bytes;
+    evictHistories();
+}
+
+/**
+ * Ajoute (ou remplace) une interaction dans le cache si l'historique de son propriétaire y est chargé, ou si toutes
+ * les tables sont en cache. Sinon, l'interaction sera lue dans la base à la première consultation de cet historique.
+ * @param i Interaction à garder en cache
+ */
+void DBInterface::cache(const Interaction& i)
+{
+    if(this->resident)
     {
-        while(query.next())
-        {
-            Interaction i;
-            i.setId(query.value(0).toInt());
-            i.setOwnerId(query.value(1).toInt());
-            i.setType(query.value(2).toInt());
-            std::string desc = query.value(3).toString().toStdString();
-            i.setDescription(desc);
-            std::string sqlDate = query.value(4).toString().toStdString();
-            Date d(sqlDate);
-            i.setDate(d);
-            c.addInteraction(i);
-            interactions.addInteraction(i);
-        }
+        this->interactions.addInteraction(i);
+        return;
     }
-    else
+
+    auto history = this->histories.find(i.getOwnerId());
+    if(history == this->histories.end())
+        return;
+
+    uncache(INTERACTION, i.getId()); // Replace: forget the size of the previous version
+    this->interactions.addInteraction(i);
+    history->second.bytes += footprint(i);
+    this->historyBytes += footprint(i);
+}
+
+/**
+ * Ajoute (ou remplace) une tâche dans le cache si l'historique de son propriétaire y est chargé, ou si toutes les
+ * tables sont en cache. Sinon, la tâche sera lue dans la base à la première consultation de cet historique.
+ * @param t Tâche à garder en cache
+ */
+void DBInterface::cache(const Todo& t)
+{
+    if(this->resident)
     {
-        qDebug() << query.lastError();
+        this->todos.addTodo(t);
+        return;
     }
+
+    auto history = this->histories.find(t.getOwnerId());
+    if(history == this->histories.end())
+        return;
+
+    uncache(TODO, t.getId()); // Replace: forget the size of the previous version
+    this->todos.addTodo(t);
+    history->second.bytes += footprint(t);
+    this->historyBytes += footprint(t);
 }
 
 /**
- * Lecture des todos d'un contact dans la base de données
- * @param c Contact
+ * Retire une interaction ou une tâche du cache (ne fait rien si elle n'y est pas)
+ * @param type Type d'entité (INTERACTION, TODO)
+ * @param id Identifiant de l'entité
  */
-void DBInterface::loadContactTodos(Contact &c)
+void DBInterface::uncache(unsigned int type, int id)
 {
-    QSqlQuery query;
-    query.prepare("SELECT * FROM todo WHERE owner_id=?"); // Using ODBC style
-    query.bindValue(0, c.getId());
-    if(query.exec())
+    int ownerId;
+    std::size_t bytes;
+    if(const Interaction* i = type == INTERACTION ? this->interactions.getInteraction(id) : nullptr)
     {
-        while(query.next())
-        {
-            Todo t;
-            t.setId(query.value(0).toInt());
-            t.setOwnerId(query.value(1).toInt());
-            std::string desc = query.value(2).toString().toStdString();
-            t.setDescription(desc);
-            std::string sqlDate = query.value(3).toString().toStdString();
-            Date d(sqlDate);
-            t.setDate(d);
-            c.addTodo(t);
-            todos.addTodo(t);
-        }
+        ownerId = i->getOwnerId();
+        bytes = footprint(*i);
+        this->interactions.remove(id);
+    }
+    else if(const Todo* t = type == TODO ? this->todos.getTodo(id) : nullptr)
+    {
+        ownerId = t->getOwnerId();
+        bytes = footprint(*t);
+        this->todos.remove(id);
     }
     else
+        return;
+
+    auto history = this->histories.find(ownerId);
+    if(history != this->histories.end())
     {
-        qDebug() << query.lastError();
+        history->second.bytes -= bytes;
+        this->historyBytes -= bytes;
     }
 }
 
 /**
- * Ajoute un contact au cache et à la base de données
- * @param c Contact à ajouter
- * @return Identifiant du contact ajouté
+ * Retire l'historique d'un contact du cache (il sera relu à la prochaine consultation)
+ * @param contactId Identifiant du contact
  */
-int DBInterface::add(Contact &c)
+void DBInterface::dropHistory(int contactId)
+{
+    auto history = this->histories.find(contactId);
+    if(history == this->histories.end())
+        return;
+
+    std::vector<int> ids;
+    for(const auto& i : this->interactions.getInteractionsOf(contactId))
+        ids.push_back(i.getId());
+    for(int id : ids)
+        this->interactions.remove(id);
+
+    ids.clear();
+    for(const auto& t : this->todos.getTodosOf(contactId))
+        ids.push_back(t.getId());
+    for(int id : ids)
+        this->todos.remove(id);
+
+    this->historyBytes -= history->second.bytes;
+    this->recentHistories.erase(history->second.recent);
+    this->histories.erase(history);
+}
+
+/**
+ * Retire du cache les historiques consultés le moins récemment tant que le budget est dépassé.
+ * L'historique consulté en dernier est conservé. Les opérations en attente gardent leurs valeurs (voir enqueue) : un
+ * historique modifié peut quitter le cache avant le flush.
+ */
+void DBInterface::evictHistories()
 {
-    QSqlQuery query;
-    if(!query.exec(QString::fromStdString(c.getQuery(CREATE))))
+    while(this->historyBytes > this->historyBudget && this->recentHistories.size() > 1)
+        dropHistory(this->recentHistories.back());
+}
+
+/**
+ * Renvoie le texte SQL d'une opération sur un type d'entité (paramètres nommés, liés par bind)
+ * @param type Type d'entité (INTERACTION, TODO, CONTACT)
+ * @param subtype Opération (UPDATE, DELETE, CREATE, LOAD pour l'historique d'un contact)
+ * @return Requête SQL
+ */
+static QString sqlOf(unsigned int type, unsigned int subtype)
+{
+    static const QString tables[] = { "interaction", "todo", "contact" };
+    if(subtype == DELETE)
+        return "DELETE FROM " + tables[type] + " WHERE id=:id";
+    if(subtype == LOAD)
+    {
+        const QString& columns = type == INTERACTION ? INTERACTION_COLUMNS : TODO_COLUMNS;
+        return "SELECT " + columns + " FROM " + tables[type] + " WHERE owner_id=:owner_id ORDER BY date_epoch";
+    }
+
+    switch(type)
+    {
+        case INTERACTION:
+            if(subtype == UPDATE)
+                return "UPDATE interaction SET type=:type, description=:description, date=:date, "
+                       "date_epoch=:date_epoch, urgent=:urgent WHERE id=:id";
+            return "INSERT INTO interaction (id, owner_id, type, description, date, date_epoch, urgent) "
+                   "VALUES (:id, :owner_id, :type, :description, :date, :date_epoch, :urgent)";
+        case TODO:
+            if(subtype == UPDATE)
+                return "UPDATE todo SET description=:description, date=:date, date_epoch=:date_epoch, "
+                       "urgent=:urgent WHERE id=:id";
+            return "INSERT INTO todo (id, owner_id, description, date, date_epoch, urgent) "
+                   "VALUES (:id, :owner_id, :description, :date, :date_epoch, :urgent)";
+        default:
+            if(subtype == UPDATE)
+                return "UPDATE contact SET first_name=:first_name, last_name=:last_name, company=:company, "
+                       "email=:email, phone=:phone, creation_date=:creation_date, creation_epoch=:creation_epoch, "
+                       "note=:note WHERE id=:id";
+            return "INSERT INTO contact "
+                   "(id, first_name, last_name, company, email, phone, creation_date, creation_epoch, note) "
+                   "VALUES (:id, :first_name, :last_name, :company, :email, :phone, :creation_date, :creation_epoch, "
+                   ":note)";
+    }
+}
+
+/**
+ * Convertit un texte pour la base de données (une chaîne vide reste une chaîne vide, pas NULL)
+ * @param s Texte à convertir
+ * @return Texte à lier à une requête
+ */
+static QString text(const std::string& s)
+{
+    return s.empty() ? QString("") : QString::fromStdString(s);
+}
+
+/**
+ * Convertit une date en sa colonne entière (voir upgradeToVersion2)
+ * @param d Date à convertir
+ * @return Date::getEpoch(), NULL si la date est invalide
+ */
+static QVariant epoch(const Date& d)
+{
+    return d.isValid() ? QVariant(static_cast<qlonglong>(d.getEpoch())) : QVariant();
+}
+
+/**
+ * Renvoie la requête préparée d'une opération sur un type d'entité.
+ * La requête est préparée à la première utilisation puis réutilisée : SQLite ne l'analyse qu'une seule fois.
+ * @param type Type d'entité (INTERACTION, TODO, CONTACT)
+ * @param subtype Opération (UPDATE, DELETE, CREATE)
+ * @return Requête préparée, prête à être liée (voir valuesOf)
+ */
+QSqlQuery& DBInterface::statement(unsigned int type, unsigned int subtype)
+{
+    auto it = this->statements.find({ type, subtype });
+    if(it != this->statements.end())
+        return it->second;
+
+    QSqlQuery query(this->db);
+    query.setForwardOnly(true); // Loaded rows are read once
+    if(!query.prepare(sqlOf(type, subtype)))
     {
         QStringList l;
-        l << "Problème d'insertion !";
+        l << "Préparation de la requête impossible !";
+        l << query.lastError().text();
+        l << sqlOf(type, subtype);
+        criticalError(l);
+    }
+    return this->statements.emplace(std::make_pair(type, subtype), query).first->second;
+}
+
+/**
+ * Renvoie les valeurs d'un contact à lier aux paramètres d'une requête préparée
+ * @param c Contact concerné
+ * @param subtype Opération (UPDATE, DELETE, CREATE)
+ * @return Valeurs, par nom de paramètre
+ */
+QVariantMap DBInterface::valuesOf(const Contact& c, unsigned int subtype)
+{
+    QVariantMap values;
+    values[":id"] = c.getId();
+    if(subtype == DELETE)
+        return values;
+
+    values[":first_name"] = text(c.getFirstName());
+    values[":last_name"] = text(c.getLastName());
+    values[":company"] = text(c.getCompany());
+    values[":email"] = text(c.getEmail());
+    values[":phone"] = text(c.getPhone());
+    values[":creation_date"] = text(c.getCreationDate().getSqlFormat());
+    values[":creation_epoch"] = epoch(c.getCreationDate());
+    values[":note"] = text(c.getNote());
+    return values;
+}
+
+/**
+ * Renvoie les valeurs d'une interaction à lier aux paramètres d'une requête préparée
+ * @param i Interaction concernée
+ * @param subtype Opération (UPDATE, DELETE, CREATE)
+ * @return Valeurs, par nom de paramètre
+ */
+QVariantMap DBInterface::valuesOf(const Interaction& i, unsigned int subtype)
+{
+    QVariantMap values;
+    values[":id"] = i.getId();
+    if(subtype == DELETE)
+        return values;
+
+    if(subtype == CREATE)
+        values[":owner_id"] = i.getOwnerId();
+    values[":type"] = i.getType();
+    values[":description"] = text(i.getDescription());
+    values[":date"] = text(i.getDate().getSqlFormat());
+    values[":date_epoch"] = epoch(i.getDate());
+    values[":urgent"] = i.isUrgent() ? 1 : 0;
+    return values;
+}
+
+/**
+ * Renvoie les valeurs d'une tâche à lier aux paramètres d'une requête préparée
+ * @param t Tâche concernée
+ * @param subtype Opération (UPDATE, DELETE, CREATE)
+ * @return Valeurs, par nom de paramètre
+ */
+QVariantMap DBInterface::valuesOf(const Todo& t, unsigned int subtype)
+{
+    QVariantMap values;
+    values[":id"] = t.getId();
+    if(subtype == DELETE)
+        return values;
+
+    if(subtype == CREATE)
+        values[":owner_id"] = t.getOwnerId();
+    values[":description"] = text(t.getDescription());
+    values[":date"] = text(t.getDate().getSqlFormat());
+    values[":date_epoch"] = epoch(t.getDate());
+    values[":urgent"] = t.isUrgent() ? 1 : 0;
+    return values;
+}
+
+/**
+ * Exécute une requête préparée et liée. En cas d'échec, affiche une erreur critique.
+ * @param query Requête à exécuter
+ * @param error Message d'erreur à afficher en cas d'échec
+ * @return Si la requête a été exécutée
+ */
+bool DBInterface::execute(QSqlQuery& query, const QString& error)
+{
+    if(query.exec())
+        return true;
+
+    QStringList l;
+    l << error;
+    l << query.lastError().text();
+    l << query.lastQuery();
+    criticalError(l);
+    return false;
+}
+
+/**
+ * Écrit un lot de lignes avec la requête préparée d'une opération (depuis le thread d'écriture)
+ * @param writer Thread d'écriture
+ * @param type Type d'entité (INTERACTION, TODO, CONTACT)
+ * @param subtype Opération (UPDATE, DELETE, CREATE)
+ * @param columns Valeurs de chaque paramètre, une par ligne
+ * @param errors Description de l'erreur en cas d'échec
+ * @return Si le lot a été écrit
+ */
+static bool writeBatch(DBExecutor& writer, unsigned int type, unsigned int subtype,
+                       const QMap<QString, QVariantList>& columns, QStringList& errors)
+{
+    QSqlQuery& query = writer.prepared(sqlOf(type, subtype));
+    for(auto it = columns.cbegin(); it != columns.cend(); ++it)
+        query.bindValue(it.key(), it.value());
+    if(query.execBatch())
+        return true;
+
+    errors << query.lastError().text();
+    errors << query.lastQuery();
+    return false;
+}
+
+/**
+ * Ouvre le journal des opérations ("<base>.oplog") et rejoue, dans une seule transaction, les opérations qui n'avaient
+ * pas été écrites dans la base de données (arrêt de l'application avant un flush). Les insertions déjà écrites sont
+ * ignorées, les modifications et suppressions sont rejouées dans leur ordre d'origine.
+ * En cas d'erreur, la transaction est annulée, le journal est gardé et une erreur critique est affichée.
+ */
+void DBInterface::replayJournal()
+{
+    if(!this->journal.open(this->db.databaseName() + ".oplog"))
+    {
+        qDebug() << "Journal des opérations indisponible : les modifications non écrites seront perdues en cas d'arrêt";
+        return;
+    }
+
+    const std::vector<OperationJournal::Record> records = this->journal.read();
+    if(records.empty())
+    {
+        this->journal.clear();
+        this->flushedUpTo = this->writtenUpTo = this->journal.end();
+        return;
+    }
+
+    QSqlQuery query(this->db);
+    bool replayed = this->db.transaction();
+    for(auto record = records.cbegin(); replayed && record != records.cend(); ++record)
+    {
+        QString sql = sqlOf(record->type, record->subtype);
+        if(record->subtype == CREATE)
+            sql.replace("INSERT INTO", "INSERT OR IGNORE INTO"); // May have been written before the stop
+        replayed = query.prepare(sql);
+        for(auto it = record->values.cbegin(); replayed && it != record->values.cend(); ++it)
+            query.bindValue(it.key(), it.value());
+        replayed = replayed && query.exec();
+    }
+
+    if(!replayed || !this->db.commit())
+    {
+        QStringList l;
+        l << "Impossible de rejouer le journal des opérations !";
         l << query.lastError().text();
         l << query.lastQuery();
+        this->db.rollback();
         criticalError(l);
-        return -1;
     }
-    int id = query.lastInsertId().toInt();
+
+    this->journal.clear();
+    this->flushedUpTo = this->writtenUpTo = this->journal.end();
+    qDebug() << "journal:" << records.size() << "opérations rejouées";
+}
+
+/**
+ * Signale une erreur survenue dans le thread d'écriture : l'erreur critique est affichée par le thread de
+ * l'interface graphique (appel mis en file d'attente).
+ * @param errors Description de l'erreur
+ */
+void DBInterface::reportError(const QStringList& errors)
+{
+    QMetaObject::invokeMethod(QCoreApplication::instance(), [this, errors]() { criticalError(errors); },
+                              Qt::QueuedConnection);
+}
+
+/**
+ * Ajoute une opération au journal (voir OperationJournal) et planifie sa synchronisation sur le disque par le thread
+ * d'écriture, sauf si une synchronisation est déjà planifiée (elle couvrira aussi cette opération).
+ * @param type Type d'entité (INTERACTION, TODO, CONTACT)
+ * @param subtype Opération (UPDATE, DELETE, CREATE)
+ * @param values Valeurs liées à la requête de l'opération (voir valuesOf)
+ */
+void DBInterface::journalize(unsigned int type, unsigned int subtype, const QVariantMap& values)
+{
+    this->journal.append(type, subtype, values);
+    if(this->journal.requestSync())
+        this->writer.submit([this](DBExecutor&) { return this->journal.sync(); });
+}
+
+/**
+ * Met en attente une opération jusqu'au prochain flush, après l'avoir ajoutée au journal.
+ * Les valeurs sont gardées avec l'opération : elle s'écrit même si l'entité a quitté le cache depuis, et elle est
+ * réappliquée sur les lignes lues tant qu'elle n'est pas écrite (voir overlay).
+ * @param type Type d'entité (INTERACTION, TODO, CONTACT)
+ * @param subtype Opération (UPDATE, DELETE, CREATE)
+ * @param id Identifiant de l'entité
+ * @param ownerId Propriétaire de l'interaction ou de la tâche (-1 pour un contact)
+ * @param values Valeurs liées à la requête de l'opération (voir valuesOf)
+ */
+void DBInterface::enqueue(unsigned int type, unsigned int subtype, int id, int ownerId, const QVariantMap& values)
+{
+    journalize(type, subtype, values);
+    this->dbTodos.push_back({{type, subtype, id}, ownerId, values, this->nextSequence++});
+}
+
+/**
+ * Oublie les opérations envoyées qui sont écrites dans la base, sauf celles dont une lecture de tables entières en
+ * cours aura besoin (voir loadResident)
+ */
+void DBInterface::pruneSent()
+{
+    std::int64_t written = this->writtenSequence.load();
+    if(!this->readMarks.empty())
+        written = std::min(written, *this->readMarks.begin());
+    while(!this->sent.empty() && this->sent.front().sequence < written)
+        this->sent.pop_front();
+}
+
+/**
+ * Réapplique, dans l'ordre, les opérations sur les interactions et les tâches qui n'étaient pas encore écrites au
+ * début d'une lecture. Chaque opération porte toutes ses valeurs : la réappliquer sur une ligne qui a été écrite
+ * pendant la lecture ne change rien.
+ * @param written Valeur de writtenSequence avant la lecture
+ * @param ownerId Propriétaire des lignes lues (-1 pour toutes les lignes)
+ * @param is Interactions lues
+ * @param ts Tâches lues
+ */
+void DBInterface::overlay(std::int64_t written, int ownerId, Interactions& is, Todos& ts) const
+{
+    for(const std::list<Operation>* operations : { &this->sent, &this->dbTodos })
+        for(const Operation& operation : *operations)
+            if(operation.sequence >= written && operation.todo.type != CONTACT
+                    && (ownerId == -1 || operation.ownerId == ownerId))
+                replay(operation, is, ts);
+}
+
+/**
+ * Réapplique, dans l'ordre, les opérations sur les contacts qui n'étaient pas encore écrites au début d'une lecture
+ * @param written Valeur de writtenSequence avant la lecture
+ * @param cs Contacts lus
+ */
+void DBInterface::overlay(std::int64_t written, Contacts& cs) const
+{
+    for(const std::list<Operation>* operations : { &this->sent, &this->dbTodos })
+        for(const Operation& operation : *operations)
+            if(operation.sequence >= written && operation.todo.type == CONTACT)
+                replay(operation, cs);
+}
+
+/**
+ * Applique une opération sur une interaction ou une tâche à des listes lues dans la base
+ * @param operation Opération à appliquer
+ * @param is Interactions
+ * @param ts Tâches
+ */
+void DBInterface::replay(const Operation& operation, Interactions& is, Todos& ts)
+{
+    const DB_todo& dbTodo = operation.todo;
+    if(dbTodo.type == INTERACTION)
+    {
+        if(dbTodo.subtype == DELETE)
+            is.remove(dbTodo.id);
+        else if(const Interaction* found = is.getInteraction(dbTodo.id); found || dbTodo.subtype == CREATE)
+        {
+            Interaction i = found ? *found : Interaction();
+            assign(i, operation.values);
+            is.addInteraction(i);
+        }
+    }
+    else if(dbTodo.type == TODO)
+    {
+        if(dbTodo.subtype == DELETE)
+            ts.remove(dbTodo.id);
+        else if(const Todo* found = ts.getTodo(dbTodo.id); found || dbTodo.subtype == CREATE)
+        {
+            Todo t = found ? *found : Todo();
+            assign(t, operation.values);
+            ts.addTodo(t);
+        }
+    }
+}
+
+/**
+ * Applique une opération sur un contact à une liste lue dans la base
+ * @param operation Opération à appliquer
+ * @param cs Contacts
+ */
+void DBInterface::replay(const Operation& operation, Contacts& cs)
+{
+    const DB_todo& dbTodo = operation.todo;
+    if(dbTodo.subtype == DELETE)
+        cs.remove(dbTodo.id);
+    else if(const Contact* found = cs.getContact(dbTodo.id); found || dbTodo.subtype == CREATE)
+    {
+        Contact c = found ? *found : Contact();
+        assign(c, operation.values);
+        cs.addContact(c);
+    }
+}
+
+/**
+ * Ajoute un contact au cache et à la base de données.
+ * L'identifiant est attribué par l'interface, l'insertion est écrite au prochain flush avec les autres opérations
+ * en attente (une seule transaction).
+ * @param c Contact à ajouter
+ * @return Identifiant du contact ajouté
+ */
+int DBInterface::add(Contact &c)
+{
+    int id = ++this->lastIds[CONTACT];
     c.setId(id);
     contacts.addContact(c);
+    enqueue(CONTACT, CREATE, id, -1, valuesOf(c, CREATE));
     return id;
 }
 
 /**
- * Ajoute une interaction au cache et à la base de données
+ * Ajoute une interaction au cache et à la base de données.
+ * L'identifiant est attribué par l'interface, l'insertion est écrite au prochain flush avec les autres opérations
+ * en attente (une seule transaction).
  * @param i Interaction à ajouter
  * @return Identifiant de l'interaction ajoutée
  */
 int DBInterface::add(Interaction &i)
 {
-    QSqlQuery query;
-    if(!query.exec(QString::fromStdString(i.getQuery(CREATE))))
-    {
-        QStringList l;
-        l << "Problème d'insertion !";
-        l << query.lastError().text();
-        l << query.lastQuery();
-        criticalError(l);
-        return -1;
-    }
-    int id = query.lastInsertId().toInt();
+    int id = ++this->lastIds[INTERACTION];
     i.setId(id);
-    interactions.addInteraction(i);
+    cache(i);
+    enqueue(INTERACTION, CREATE, id, i.getOwnerId(), valuesOf(i, CREATE));
     return id;
 }
 
 /**
- * Ajoute un todo au cache et à la base de données
+ * Ajoute un todo au cache et à la base de données.
+ * L'identifiant est attribué par l'interface, l'insertion est écrite au prochain flush avec les autres opérations
+ * en attente (une seule transaction).
  * @param t todo à ajouter
  * @return Identifiant du todo ajouté
  */
 int DBInterface::add(Todo &t)
 {
-    QSqlQuery query;
-    if(!query.exec(QString::fromStdString(t.getQuery(CREATE))))
-    {
-        QStringList l;
-        l << "Problème d'insertion !";
-        l << query.lastError().text();
-        l << query.lastQuery();
-        criticalError(l);
-        return -1;
-    }
-
-    int id = query.lastInsertId().toInt();
+    int id = ++this->lastIds[TODO];
     t.setId(id);
-    todos.addTodo(t);
+    cache(t);
+    enqueue(TODO, CREATE, id, t.getOwnerId(), valuesOf(t, CREATE));
     return id;
 }
 
@@ -278,11 +1216,10 @@ int DBInterface::add(Todo &t)
  */
 void DBInterface::update(Contact &c)
 {
-    Contact* pContact = this->contacts.getContact(c.getId());
-    if(pContact)
-        *pContact = c;
+    if(this->contacts.getContact(c.getId()))
+        this->contacts.addContact(c); // Replace (keeps the search index up to date)
 
-    this->dbTodos.push_back({CONTACT, UPDATE, c.getId()});
+    enqueue(CONTACT, UPDATE, c.getId(), -1, valuesOf(c, UPDATE));
 }
 
 /**
@@ -291,11 +1228,9 @@ void DBInterface::update(Contact &c)
  */
 void DBInterface::update(Interaction &i)
 {
-    Interaction* pInteraction = this->interactions.getInteraction(i.getId());
-    if(pInteraction)
-        *pInteraction = i;
+    cache(i); // Replace if its history is in cache (keeps the owner index up to date)
 
-    this->dbTodos.push_back({INTERACTION, UPDATE, i.getId()});
+    enqueue(INTERACTION, UPDATE, i.getId(), i.getOwnerId(), valuesOf(i, UPDATE));
 }
 
 /**
@@ -304,86 +1239,177 @@ void DBInterface::update(Interaction &i)
  */
 void DBInterface::update(Todo &t)
 {
+    cache(t); // Replace if its history is in cache (keeps the owner index up to date)
 
-    Todo* pTodo = this->todos.getTodo(t.getId());
-    if(pTodo)
-        *pTodo = t;
-
-    this->dbTodos.push_back({TODO, UPDATE, t.getId()});
+    enqueue(TODO, UPDATE, t.getId(), t.getOwnerId(), valuesOf(t, UPDATE));
 }
 
 /**
- * Supprime un contact de la base de données.
+ * Supprime un contact de la base de données, avec ses tâches.
+ * Le contact et ses tâches quittent le cache immédiatement, la suppression est écrite au prochain flush. Ses
+ * interactions restent dans la base : elles ne quittent le cache qu'avec son historique (pas si toutes les tables
+ * sont en cache, voir whenResident).
  * @param c Contact à supprimer
  */
 void DBInterface::remove(Contact &c)
 {
-    this->dbTodos.push_back({CONTACT, DELETE, c.getId()});
+    loadHistory(c.getId());
+    enqueue(CONTACT, DELETE, c.getId(), -1, valuesOf(c, DELETE));
 
-    for(const Todo& t: c.getTodos())
-        this->dbTodos.push_back({TODO, DELETE, t.getId()});
+    std::vector<int> ids;
+    for(const Todo& t: this->todos.getTodosOf(c.getId()))
+        ids.push_back(t.getId());
+    for(int id : ids)
+    {
+        QVariantMap values;
+        values[":id"] = id;
+        enqueue(TODO, DELETE, id, c.getId(), values);
+        uncache(TODO, id);
+    }
+
+    this->contacts.remove(c.getId());
+    dropHistory(c.getId());
 }
 
 /**
  * @Supprime une interaction de la base de données.
+ * L'interaction quitte le cache immédiatement, la suppression est écrite au prochain flush.
  * @param i Interaction à supprimer
  */
 void DBInterface::remove(Interaction &i)
 {
-    this->dbTodos.push_back({INTERACTION, DELETE, i.getId()});
+    enqueue(INTERACTION, DELETE, i.getId(), i.getOwnerId(), valuesOf(i, DELETE));
+    uncache(INTERACTION, i.getId());
 }
 
 /**
  * Supprime une tâche de la base de données
+ * La tâche quitte le cache immédiatement, la suppression est écrite au prochain flush.
  * @param t todo à supprimer
  */
 void DBInterface::remove(Todo &t)
 {
-    this->dbTodos.push_back({TODO, DELETE, t.getId()});
+    enqueue(TODO, DELETE, t.getId(), t.getOwnerId(), valuesOf(t, DELETE));
+    uncache(TODO, t.getId());
+}
+
+/**
+ * Indique si des opérations n'ont pas encore été confirmées par un flush (modifications en attente ou opérations
+ * encore présentes dans le journal)
+ * @return S'il reste des opérations à écrire
+ */
+bool DBInterface::hasPendingChanges()
+{
+    return !this->dbTodos.empty() || this->journal.end() != this->flushedUpTo;
+}
+
+/**
+ * Ordre d'écriture d'un lot : les contacts créés avant leurs interactions et leurs tâches, les contacts modifiés ou
+ * supprimés après
+ * @param type Type d'entité (INTERACTION, TODO, CONTACT)
+ * @param subtype Opération (UPDATE, DELETE, CREATE)
+ * @return Rang du lot (les lots sont écrits par rang croissant)
+ */
+static int batchRank(unsigned int type, unsigned int subtype)
+{
+    if(type != CONTACT)
+        return 1;
+    return subtype == CREATE ? 0 : 2;
 }
 
 /**
- * Met à jour la base de données avec l'ensemble des données contenues dans le cache de l'interface.
- * En cas d'erreur, un retour est renvoyé dans le retour Debug() et la sauvegarde de cette entité est annulée.
+ * Met à jour la base de données avec l'ensemble des opérations en attente (créations, modifications, suppressions).
+ * Les opérations en attente sont d'abord compactées : une seule opération par entité est conservée (la suppression
+ * l'emporte sur les modifications, plusieurs modifications n'en font qu'une, une création garde ses modifications et
+ * disparaît avec sa suppression). Elles sont ensuite regroupées par type d'entité et par opération et envoyées par
+ * lots (une requête préparée par lot) dans une seule transaction, écrite par le thread d'écriture (voir DBExecutor) :
+ * l'appel n'attend pas SQLite.
+ * Une fois la transaction validée, les opérations écrites sont retirées du journal, seulement si tous les flush
+ * précédents ont eux aussi été écrits : plusieurs actions de l'utilisateur peuvent être regroupées dans un seul flush
+ * sans risque de perte.
+ * En cas d'erreur, la transaction est annulée (les opérations restent dans le journal) et une erreur critique est
+ * affichée.
+ * @return Nombre d'opérations envoyées et ignorées, et résultat de l'écriture
  */
-void DBInterface::flush()
+DBInterface::FlushReport DBInterface::flush()
 {
-    QSqlQuery query; // Query object
-    QString q; // Query string
+    FlushReport report;
+
+    // Compact: one operation per entity, in the order of the first one
+    std::map<std::pair<unsigned int, int>, Operation> pending;
+    for(const auto& operation : this->dbTodos) {
+        const DB_todo& dbTodo = operation.todo;
+        auto [it, inserted] = pending.emplace(std::make_pair(dbTodo.type, dbTodo.id), operation);
+        if(inserted)
+            continue;
 
-    // Get query from method ->getQuery()
-    for(auto& dbTodo : this->dbTodos) {
-        switch(dbTodo.type)
+        Operation& compacted = it->second;
+        if(dbTodo.subtype == DELETE) {
+            if(compacted.todo.subtype == CREATE)
+                pending.erase(it); // Never written: nothing to delete
+            else
+                compacted = operation;
+        }
+        else if(compacted.todo.subtype == CREATE) {
+            for(auto value = operation.values.cbegin(); value != operation.values.cend(); ++value)
+                compacted.values[value.key()] = value.value(); // Inserted with its last values
+        }
+        else if(compacted.todo.subtype == UPDATE)
+            compacted.values = operation.values;
+    }
+    report.skipped = this->dbTodos.size() - pending.size();
+
+    // Group the bound values by (rank, type, operation): contacts are created before their children
+    std::map<std::tuple<int, unsigned int, unsigned int>, QMap<QString, QVariantList>> batches;
+    for(const auto& [entity, operation] : pending) {
+        auto& columns = batches[{ batchRank(operation.todo.type, operation.todo.subtype), operation.todo.type,
+                                  operation.todo.subtype }];
+        for(auto it = operation.values.cbegin(); it != operation.values.cend(); ++it)
+            columns[it.key()] << it.value();
+        report.executed++;
+    }
+
+    // Written by the writer thread: the interface does not wait for SQLite. Every operation journalized since the
+    // last flush is in these batches.
+    const std::int64_t from = this->flushedUpTo;
+    const std::int64_t journalized = this->journal.end();
+    const std::int64_t sequence = this->nextSequence;
+    this->flushedUpTo = journalized;
+    report.written = this->writer.submit([this, batches, from, journalized, sequence](DBExecutor& writer) {
+        QSqlDatabase& connection = writer.database();
+        QStringList errors;
+        bool written = batches.empty() || connection.transaction();
+        if(!written)
+            errors << connection.lastError().text();
+        for(auto batch = batches.cbegin(); written && batch != batches.cend(); ++batch)
+            written = writeBatch(writer, std::get<1>(batch->first), std::get<2>(batch->first), batch->second, errors);
+        if(written && !batches.empty() && !connection.commit())
         {
-            case INTERACTION:
-            q = QString::fromStdString(interactions.getInteraction(dbTodo.id)->getQuery(dbTodo.subtype).c_str());
-            if(dbTodo.type == DELETE)
-                this->interactions.remove(dbTodo.id);
-            break;
-            case TODO:
-                q = QString::fromStdString(todos.getTodo(dbTodo.id)->getQuery(dbTodo.subtype).c_str());
-                if(dbTodo.type == DELETE)
-                    this->todos.remove(dbTodo.id);
-                break;
-            case CONTACT:
-                q = QString::fromStdString(contacts.getContact(dbTodo.id)->getQuery(dbTodo.subtype).c_str());
-                if(dbTodo.type == DELETE)
-                    this->contacts.remove(dbTodo.id);
-
-            default:
-                break;
+            errors << connection.lastError().text();
+            written = false;
         }
-        if(!query.exec(q)) // Process
+
+        if(!written)
         {
-            QStringList l;
-            l << "Problème pour sauvegarder les données ! ";
-            l << query.lastError().text();
-            l << query.lastQuery();
-            criticalError(l);
+            connection.rollback(); // Kept in the journal: replayed on the next start
+            reportError(QStringList() << "Problème pour sauvegarder les données ! " << errors);
         }
-    }
+        else if(this->writtenUpTo == from)
+        {
+            // Every previous flush has been written: a failed flush keeps its records, and those of the following
+            // flushes, in the journal
+            this->journal.discard(journalized);
+            this->writtenUpTo = journalized;
+            this->writtenSequence = sequence; // Reads no longer need to replay these operations
+        }
+        return written;
+    }).share();
 
-    this->dbTodos.clear(); // Clear cache
+    this->sent.splice(this->sent.end(), this->dbTodos); // Replayed on the rows read until they are written
+    pruneSent();
+
+    qDebug() << "flush:" << report.executed << "opérations envoyées," << report.skipped << "ignorées";
+    return report;
 }
 
 /**
@@ -408,24 +1434,50 @@ void DBInterface::criticalError(QString error)
     exit(1);
 }
 
+/**
+ * Constructeur de l'interface, avec le profil de stockage par défaut.
+ * @param path Lien vers la base de données SQLite
+ * @param historyBudget Mémoire (estimée, en octets) que peuvent occuper les historiques en cache
+ */
+DBInterface::DBInterface(std::string path, std::size_t historyBudget)
+    : DBInterface(std::move(path), StorageProfile(), historyBudget)
+{
+}
+
 /**
  * Constructeur de l'interface.
  * @param path Lien vers la base de données SQLite
+ * @param profile Réglages de stockage appliqués à l'ouverture (voir StorageProfile)
+ * @param historyBudget Mémoire (estimée, en octets) que peuvent occuper les historiques en cache
  */
-DBInterface::DBInterface(std::string path)
+DBInterface::DBInterface(std::string path, StorageProfile profile, std::size_t historyBudget)
+    : profile(std::move(profile)), historyBudget(historyBudget)
 {
-    dbTodos = std::list<DB_todo>();
+    dbTodos = std::list<Operation>();
+    contacts.attach(&interactions, &todos);
     db = QSqlDatabase::addDatabase("QSQLITE");
     db.setDatabaseName(QString::fromStdString(path));
+    db.setConnectOptions("QSQLITE_BUSY_TIMEOUT=5000"); // The writer thread may hold a lock
 }
 
 /**
- * Constructeur sans paramètre: Initialise automatiquement le lien vers la base de données par "CDAA.db".
+ * Constructeur sans paramètre: Initialise automatiquement le lien vers la base de données par "CDAA.db", et lit le
+ * profil de stockage dans "data/storage.ini" s'il existe (voir StorageProfile::fromFile).
  */
-DBInterface::DBInterface() : DBInterface(std::string("data/CDAA.db")) {}
+DBInterface::DBInterface()
+    : DBInterface(std::string("data/CDAA.db"), StorageProfile::fromFile("data/storage.ini")) {}
 
 /**
- * Destructeur par défaut (géré par le compilateur)
+ * Destructeur : les lectures de tables entières en cours sont attendues (sans être remises), les modifications en
+ * attente sont envoyées (flush) et les écritures terminées avant l'arrêt du thread d'écriture
  */
-DBInterface::~DBInterface() = default;
+DBInterface::~DBInterface()
+{
+    this->alive.reset(); // Tables read by loadResident are no longer delivered
+    for(auto& read : this->wholeReads)
+        read.wait(); // They use the read-only connections
+    if(writer.isStarted() && hasPendingChanges())
+        flush();
+    writer.stop();
+}
 
@@ -14,46 +14,168 @@
 #include "utils.h"
 #include "todo.h"
 #include "interaction.h"
+#include "connectionpool.h"
+#include "dbexecutor.h"
+#include "operationjournal.h"
+#include "storageprofile.h"
+#include <QCoreApplication>
 #include <QDebug>
+#include <QElapsedTimer>
 #include <QtSql>
 #include <QMessageBox>
+#include <atomic>
+#include <functional>
+#include <future>
+#include <list>
+#include <map>
+#include <memory>
+#include <set>
+#include <unordered_map>
+#include <utility>
 
 /**
  * L'interface permet de gérer plus facilement et plus efficacement la base de données.
  * Elle permet de charger les données, et de les stockers. Le données modifiées sont actualisées dans la base de données
  * quand la méthode flush est appelée. Cela limite un maximum les appels inutiles vers la base de données.
+ * Chaque opération est d'abord ajoutée à un journal (OperationJournal) rejoué au démarrage : les flush peuvent être
+ * espacés et regrouper plusieurs actions de l'utilisateur sans risque de perte.
+ * L'interface possède l'unique copie des données de l'application : les contacts sont reliés aux listes
+ * d'interactions et de tâches (par l'identifiant de leur propriétaire), le reste de l'application n'y accède qu'en
+ * lecture, par référence.
+ * Les contacts sont tous chargés au démarrage, l'historique d'un contact (interactions et tâches) n'est lu qu'à sa
+ * première consultation (loadHistory) et gardé dans un cache LRU dont la mémoire est bornée (setHistoryBudget).
+ * Dès qu'une vue globale en a besoin (whenResident), toutes les interactions et toutes les tâches sont lues une seule
+ * fois puis restent en cache, tenues à jour par add, update et remove : les historiques ne sont alors plus relus.
+ * Les écritures (flush) sont exécutées par un thread dédié (DBExecutor) avec sa propre connexion :
+ * l'interface graphique n'attend jamais SQLite. Les lectures n'attendent pas non plus les écritures : les opérations
+ * pas encore écrites sont réappliquées sur les lignes lues (voir overlay).
+ * Les tables entières sont lues par d'autres threads, chacun avec sa connexion (ConnectionPool), et remises au
+ * thread de l'interface graphique.
  * @brief Interface de base de données.
  */
 class DBInterface
 {
+public:
+    /**
+     * Bilan d'un appel à flush()
+     */
+    struct FlushReport
+    {
+        std::size_t executed = 0; /*!< Opérations écrites dans la base de données */
+        std::size_t skipped = 0; /*!< Opérations ignorées (remplacées par une autre opération ou entité introuvable) */
+        std::shared_future<bool> written; /*!< Résultat de l'écriture, disponible une fois le lot écrit */
+    };
+
 private:
     QSqlDatabase db; /*!< Connexion à la base de données SQLite. */
+    StorageProfile profile; /*!< Réglages de stockage appliqués à l'ouverture */
     Contacts contacts; /*!< Listes des contacts en base de données */
     Todos todos; /*!< Listes des todos en base de données */
     Interactions interactions; /*!< Listes des interactions en base de données */
 
-    std::list<DB_todo> dbTodos; /*!< Listes des tâches a effectuer en cas de flush() */
-    // Contains only update and delete, created value is insert immediatly to get id
+    /**
+     * Opération en attente d'écriture (voir flush)
+     */
+    struct Operation
+    {
+        DB_todo todo; /*!< Type, sous-type et identifiant de l'entité */
+        int ownerId; /*!< Propriétaire de l'interaction ou de la tâche (-1 pour un contact) */
+        QVariantMap values; /*!< Valeurs liées à la requête de l'opération (voir valuesOf) */
+        std::int64_t sequence; /*!< Numéro d'ordre de l'opération */
+    };
+
+    std::list<Operation> dbTodos; /*!< Listes des tâches a effectuer en cas de flush() (créations comprises) */
+    std::list<Operation> sent; /*!< Opérations envoyées par flush() et peut-être pas encore écrites (voir overlay) */
+    std::int64_t nextSequence = 0; /*!< Numéro d'ordre de la prochaine opération */
+    std::atomic<std::int64_t> writtenSequence{0}; /*!< Les opérations de numéro inférieur sont écrites dans la base */
+    std::multiset<std::int64_t> readMarks; /*!< writtenSequence au début de chaque lecture de tables entières en cours */
+    std::list<std::future<void>> wholeReads; /*!< Lectures de tables entières en cours (voir loadResident) */
+    std::shared_ptr<bool> alive = std::make_shared<bool>(true); /*!< Expire à la destruction (voir loadResident) */
+    bool resident = false; /*!< Toutes les interactions et toutes les tâches sont en cache (voir whenResident) */
+    std::vector<std::function<void()>> residentWaiters; /*!< Appelés quand les tables seront en cache */
+    OperationJournal journal; /*!< Journal des opérations pas encore écrites (rejoué au démarrage) */
+    std::int64_t flushedUpTo = 0; /*!< Fin du journal au dernier flush (voir OperationJournal::end) */
+    std::int64_t writtenUpTo = 0; /*!< Fin du journal écrite sans interruption dans la base (thread d'écriture) */
+    int lastIds[3] = { 0, 0, 0 }; /*!< Derniers identifiants attribués, par type (voir DBTodoTypes) */
+
+    std::map<std::pair<unsigned int, unsigned int>, QSqlQuery> statements; /*!< Requêtes préparées, par (type, sous-type) */
+
+    /**
+     * Historique d'un contact gardé en cache
+     */
+    struct CachedHistory
+    {
+        std::list<int>::iterator recent; /*!< Position dans recentHistories */
+        std::size_t bytes; /*!< Mémoire occupée (estimation, en octets) */
+    };
+
+    std::size_t historyBudget; /*!< Mémoire maximale des historiques en cache (estimation, en octets) */
+    std::size_t historyBytes = 0; /*!< Mémoire occupée par les historiques en cache (estimation, en octets) */
+    std::list<int> recentHistories; /*!< Contacts dont l'historique est en cache, du plus au moins récemment consulté */
+    std::unordered_map<int, CachedHistory> histories; /*!< Historiques en cache, par identifiant de contact */
 
     void clearCache();
 
-    void loadContactInteractions(Contact& c);
-    void loadContactTodos(Contact& c);
-    void loadOtherInteractions();
+    QSqlQuery& statement(unsigned int type, unsigned int subtype);
+    static QVariantMap valuesOf(const Contact& c, unsigned int subtype);
+    static QVariantMap valuesOf(const Interaction& i, unsigned int subtype);
+    static QVariantMap valuesOf(const Todo& t, unsigned int subtype);
+    bool execute(QSqlQuery& query, const QString& error);
+    void applyProfile();
+    void replayJournal();
+    void journalize(unsigned int type, unsigned int subtype, const QVariantMap& values);
+    void enqueue(unsigned int type, unsigned int subtype, int id, int ownerId, const QVariantMap& values);
+    void pruneSent();
+    void overlay(std::int64_t written, int ownerId, Interactions& is, Todos& ts) const;
+    void overlay(std::int64_t written, Contacts& cs) const;
+    static void replay(const Operation& operation, Interactions& is, Todos& ts);
+    static void replay(const Operation& operation, Contacts& cs);
+    static constexpr int SCHEMA_VERSION = 3; /*!< Version de la structure attendue (PRAGMA user_version) */
+    int schemaVersion();
+    void migrate();
+    bool upgradeTo(int version, QSqlQuery& query);
+    bool addColumn(QSqlQuery& query, const QString& table, const QString& column, const QString& definition);
+    bool upgradeToVersion1(QSqlQuery& query);
+    bool upgradeToVersion2(QSqlQuery& query);
+    bool upgradeToVersion3(QSqlQuery& query);
+
+    std::size_t countRows(const QString& table);
+    int lastId(const QString& table);
+    bool loadContacts();
+    [[nodiscard]] Interactions loadAllInteractions();
+    [[nodiscard]] Todos loadAllTodos();
+    void loadResident();
+
+    void cache(const Interaction& i);
+    void cache(const Todo& t);
+    void uncache(unsigned int type, int id);
+    void dropHistory(int contactId);
+    void evictHistories();
 
     void criticalError(QStringList errors);
     void criticalError(QString error);
+    void reportError(const QStringList& errors);
 
+    ConnectionPool readers{"cdaa_reader_"}; /*!< Connexions de lecture, une par thread */
+
+    // Declared last: destroyed first, so pending writes are done before anything else goes away
+    DBExecutor writer{"cdaa_writer"}; /*!< Thread d'écriture, avec sa propre connexion */
 
 public:
     bool open();
     [[nodiscard]] bool isOpen();
 
+    static constexpr std::size_t DEFAULT_HISTORY_BUDGET = 32 * 1024 * 1024; /*!< Budget par défaut des historiques */
+
     bool loadData();
+    void loadHistory(int contactId);
+    void setHistoryBudget(std::size_t bytes);
+    void whenResident(std::function<void()> ready);
+    [[nodiscard]] bool isResident() const;
 
-    [[nodiscard]] Contacts getContacts();
-    [[nodiscard]] Todos getTodos();
-    [[nodiscard]] Interactions getInteractions();
+    [[nodiscard]] const Contacts& getContacts() const;
+    [[nodiscard]] const Todos& getTodos() const;
+    [[nodiscard]] const Interactions& getInteractions() const;
 
     void update(Contact& c);
     void update(Interaction& i);
@@ -67,11 +189,15 @@ public:
     void remove(Interaction& i);
     void remove(Todo& t);
 
-    void flush();
+    [[nodiscard]] bool hasPendingChanges();
+    FlushReport flush();
 
     // Constructor & destructor
-    DBInterface(std::string path);
+    explicit DBInterface(std::string path, std::size_t historyBudget = DEFAULT_HISTORY_BUDGET);
+    DBInterface(std::string path, StorageProfile profile, std::size_t historyBudget = DEFAULT_HISTORY_BUDGET);
     DBInterface();
+    DBInterface(const DBInterface&) = delete;
+    DBInterface& operator=(const DBInterface&) = delete;
     ~DBInterface();
 };
 
@@ -31,7 +31,7 @@ EditContactDialog::EditContactDialog(QWidget *parent) :
  * @param c Contact a modifier
  * @param parent classe parente (défault =  null)
  */
-EditContactDialog::EditContactDialog(Contact* c, QWidget *parent) :
+EditContactDialog::EditContactDialog(const Contact* c, QWidget *parent) :
     QDialog(parent),
     ui(new Ui::EditContactDialog)
 {
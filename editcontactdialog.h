@@ -43,7 +43,7 @@ public:
     [[nodiscard]] Todos getTodos();
     [[nodiscard]] std::string getPicturePath() const;
     EditContactDialog(QWidget *parent = nullptr);
-    EditContactDialog(Contact* c, QWidget *parent = nullptr); // Edit mode
+    EditContactDialog(const Contact* c, QWidget *parent = nullptr); // Edit mode
     ~EditContactDialog();
 
 private slots:
@@ -0,0 +1,550 @@
+/**
+ * @file entitystore.h
+ *
+ * @brief Déclaration et définition de la classe template EntityStore (stockage indexé d'entités) et de ses index
+ *
+ * @author LEESTMANS Richard
+ * @author COUDERT Nicolas
+ */
+
+#ifndef CDAA_ENTITYSTORE_H
+#define CDAA_ENTITYSTORE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <set>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "dateindex.h"
+#include "view.h"
+
+/**
+ * Stockage contigu d'entités (Contact, Todo, Interaction...) identifiées par un entier (getId()).
+ * Les entités sont indexées par identifiant : recherche, remplacement et suppression (la dernière entité prend la
+ * place de celle supprimée) se font en temps constant. Les entités sans identifiant (< 0) sont stockées mais ne sont
+ * indexées nulle part.
+ * Les index secondaires sont choisis à la compilation (Indexes...) : chacun fournit link(entité), unlink(entité) et
+ * clear(), appelés à chaque ajout, remplacement ou suppression, sans appel virtuel. Une entité de la liste se modifie
+ * donc en la remplaçant (add) : get() et les itérateurs sont constants.
+ * Voir ByDate, ByOwner, UrgentIds et ByDueDate pour les index communs.
+ * \brief Stockage indexé d'entités
+ * @tparam T Type des entités
+ * @tparam Indexes Index secondaires
+ */
+template<typename T, typename... Indexes>
+class EntityStore
+{
+private:
+    std::vector<T> elements; /*!< Entités (stockage contigu) */
+    std::unordered_map<int, std::size_t> positions; /*!< Position de chaque entité, par identifiant */
+    std::tuple<Indexes...> indexes; /*!< Index secondaires */
+
+    void link(const T& element);
+    void unlink(const T& element);
+    void reindex();
+
+    static int idOf(int id);
+    static int idOf(const DateIndex::Entry& entry);
+
+public:
+    using const_iterator = typename std::vector<T>::const_iterator;
+
+    const T& add(const T& element);
+    void remove(int id);
+    void remove(const T& element);
+    void clear();
+    void reserve(std::size_t count);
+
+    [[nodiscard]] std::size_t size() const;
+    [[nodiscard]] bool isIndexed() const;
+    [[nodiscard]] const T* get(int id) const;
+    [[nodiscard]] const std::vector<T>& data() const;
+
+    template<typename Less>
+    void sort(Less less);
+
+    template<typename Index>
+    [[nodiscard]] const Index& index() const;
+
+    template<typename Range>
+    [[nodiscard]] View<T> view(Range range) const;
+    template<typename Runs, typename Less>
+    [[nodiscard]] View<T> merge(Runs runs, Less less) const;
+
+    const_iterator begin() const;
+    const_iterator end() const;
+};
+
+/**
+ * Index secondaire : identifiants des entités par date (getDate())
+ */
+class ByDate
+{
+private:
+    DateIndex dates; /*!< Identifiants, par date */
+
+public:
+    /**
+     * Indexe une entité
+     * @param element Entité
+     */
+    template<typename T>
+    void link(const T& element) { this->dates.insert(element.getDate().getEpoch(), element.getId()); }
+
+    /**
+     * Retire une entité de l'index
+     * @param element Entité (telle qu'elle a été indexée)
+     */
+    template<typename T>
+    void unlink(const T& element) { this->dates.erase(element.getDate().getEpoch(), element.getId()); }
+
+    /**
+     * Vide l'index
+     */
+    void clear() { this->dates.clear(); }
+
+    /**
+     * Renvoie l'index des dates
+     * @return Index des dates
+     */
+    [[nodiscard]] const DateIndex& get() const { return this->dates; }
+};
+
+/**
+ * Index secondaire : identifiants des entités de chaque propriétaire (getOwnerId()), par date
+ */
+class ByOwner
+{
+private:
+    DateIndex empty; /*!< Index vide (propriétaire sans entité) */
+    std::unordered_map<int, DateIndex> owners; /*!< Identifiants de chaque propriétaire, par date */
+
+public:
+    /**
+     * Indexe une entité
+     * @param element Entité
+     */
+    template<typename T>
+    void link(const T& element)
+    {
+        this->owners[element.getOwnerId()].insert(element.getDate().getEpoch(), element.getId());
+    }
+
+    /**
+     * Retire une entité de l'index (et son propriétaire s'il n'a plus d'entité)
+     * @param element Entité (telle qu'elle a été indexée)
+     */
+    template<typename T>
+    void unlink(const T& element)
+    {
+        auto owner = this->owners.find(element.getOwnerId());
+        if(owner == this->owners.end())
+            return;
+
+        owner->second.erase(element.getDate().getEpoch(), element.getId());
+        if(owner->second.empty())
+            this->owners.erase(owner);
+    }
+
+    /**
+     * Vide l'index
+     */
+    void clear() { this->owners.clear(); }
+
+    /**
+     * Renvoie l'index des dates d'un propriétaire
+     * @param ownerId Identifiant du propriétaire
+     * @return Index des dates du propriétaire (vide s'il n'a aucune entité)
+     */
+    [[nodiscard]] const DateIndex& of(int ownerId) const
+    {
+        auto owner = this->owners.find(ownerId);
+        return owner == this->owners.end() ? this->empty : owner->second;
+    }
+
+    /**
+     * Renvoie l'index des dates de plusieurs propriétaires (ceux sans entité sont ignorés)
+     * @param ownerIds Identifiants des propriétaires
+     * @return Intervalles triés par date, un par propriétaire
+     */
+    [[nodiscard]] std::vector<DateIndex::Range> runsOf(const std::vector<int>& ownerIds) const
+    {
+        std::vector<DateIndex::Range> runs;
+        runs.reserve(ownerIds.size());
+        for(int ownerId : ownerIds) {
+            auto owner = this->owners.find(ownerId);
+            if(owner != this->owners.end())
+                runs.push_back(owner->second.all());
+        }
+        return runs;
+    }
+};
+
+/**
+ * Index secondaire : identifiants des entités urgentes (isUrgent())
+ */
+class UrgentIds
+{
+private:
+    std::set<int> ids; /*!< Identifiants des entités urgentes */
+
+public:
+    /**
+     * Indexe une entité (si elle est urgente)
+     * @param element Entité
+     */
+    template<typename T>
+    void link(const T& element)
+    {
+        if(element.isUrgent())
+            this->ids.insert(element.getId());
+    }
+
+    /**
+     * Retire une entité de l'index
+     * @param element Entité
+     */
+    template<typename T>
+    void unlink(const T& element) { this->ids.erase(element.getId()); }
+
+    /**
+     * Vide l'index
+     */
+    void clear() { this->ids.clear(); }
+
+    /**
+     * Renvoie les identifiants des entités urgentes
+     * @return Intervalle [first; second[ des identifiants (croissants)
+     */
+    [[nodiscard]] std::pair<std::set<int>::const_iterator, std::set<int>::const_iterator> all() const
+    {
+        return { this->ids.begin(), this->ids.end() };
+    }
+};
+
+/**
+ * Index secondaire : identifiants des entités non urgentes et datées, par échéance (getDate())
+ */
+class ByDueDate
+{
+private:
+    DateIndex due; /*!< Identifiants, par échéance */
+
+public:
+    /**
+     * Indexe une entité (si elle n'est pas urgente et a une date valide)
+     * @param element Entité
+     */
+    template<typename T>
+    void link(const T& element)
+    {
+        if(!element.isUrgent() && element.getDate().isValid())
+            this->due.insert(element.getDate().getEpoch(), element.getId());
+    }
+
+    /**
+     * Retire une entité de l'index
+     * @param element Entité (telle qu'elle a été indexée)
+     */
+    template<typename T>
+    void unlink(const T& element) { this->due.erase(element.getDate().getEpoch(), element.getId()); }
+
+    /**
+     * Vide l'index
+     */
+    void clear() { this->due.clear(); }
+
+    /**
+     * Renvoie les entités dont l'échéance est strictement antérieure à une date
+     * @param epoch Date (Date::getEpoch())
+     * @return Intervalle des entités, de la plus ancienne échéance à la plus récente
+     */
+    [[nodiscard]] DateIndex::Range before(std::int64_t epoch) const
+    {
+        if(epoch == std::numeric_limits<std::int64_t>::min())
+            return this->due.none();
+        return this->due.between(std::numeric_limits<std::int64_t>::min(), epoch - 1);
+    }
+
+    /**
+     * Renvoie les entités dont l'échéance est postérieure ou égale à une date
+     * @param epoch Date (Date::getEpoch())
+     * @return Intervalle des entités, de la plus proche échéance à la plus lointaine
+     */
+    [[nodiscard]] DateIndex::Range from(std::int64_t epoch) const
+    {
+        return this->due.between(epoch, std::numeric_limits<std::int64_t>::max());
+    }
+};
+
+/**
+ * Ajoute une entité à tous les index secondaires
+ * @param element Entité (avec identifiant)
+ */
+template<typename T, typename... Indexes>
+void EntityStore<T, Indexes...>::link(const T& element)
+{
+    std::apply([&element](auto&... index) { (index.link(element), ...); }, this->indexes);
+}
+
+/**
+ * Retire une entité de tous les index secondaires
+ * @param element Entité (telle qu'elle a été indexée)
+ */
+template<typename T, typename... Indexes>
+void EntityStore<T, Indexes...>::unlink(const T& element)
+{
+    std::apply([&element](auto&... index) { (index.unlink(element), ...); }, this->indexes);
+}
+
+/**
+ * Reconstruit l'index des identifiants (après un tri ou une suppression groupée).
+ * Les index secondaires ne dépendent que des identifiants, pas des positions : ils ne changent pas.
+ */
+template<typename T, typename... Indexes>
+void EntityStore<T, Indexes...>::reindex()
+{
+    this->positions.clear();
+    for(std::size_t i = 0; i < this->elements.size(); i++)
+        if(this->elements[i].getId() >= 0)
+            this->positions[this->elements[i].getId()] = i;
+}
+
+/**
+ * Identifiant désigné par une poignée d'index (identifiant seul)
+ * @param id Identifiant
+ * @return Identifiant
+ */
+template<typename T, typename... Indexes>
+int EntityStore<T, Indexes...>::idOf(int id)
+{
+    return id;
+}
+
+/**
+ * Identifiant désigné par une poignée d'index (élément d'un DateIndex)
+ * @param entry Élément d'un index de dates
+ * @return Identifiant
+ */
+template<typename T, typename... Indexes>
+int EntityStore<T, Indexes...>::idOf(const DateIndex::Entry& entry)
+{
+    return entry.id;
+}
+
+/**
+ * Ajoute une entité. Si une entité avec le même identifiant existe déjà, elle est remplacée (et réindexée).
+ * C'est le seul moyen de modifier une entité de la liste : les accès (get, itérateurs) sont constants pour que les
+ * index restent synchronisés.
+ * @param element Entité à ajouter
+ * @return Entité stockée (constante)
+ */
+template<typename T, typename... Indexes>
+const T& EntityStore<T, Indexes...>::add(const T& element)
+{
+    if(element.getId() < 0) { // Not saved yet: not indexed
+        this->elements.push_back(element);
+        return this->elements.back();
+    }
+
+    auto slot = this->positions.find(element.getId());
+    if(slot != this->positions.end()) {
+        T& old = this->elements[slot->second];
+        unlink(old); // Indexed fields may change
+        old = element;
+        link(old);
+        return old;
+    }
+
+    this->positions.emplace(element.getId(), this->elements.size());
+    this->elements.push_back(element);
+    link(this->elements.back());
+    return this->elements.back();
+}
+
+/**
+ * Retire l'entité avec l'identifiant précisé (ne fait rien si elle n'existe pas).
+ * La dernière entité prend la place de celle supprimée (l'ordre n'est pas conservé).
+ * @param id Identifiant de l'entité
+ */
+template<typename T, typename... Indexes>
+void EntityStore<T, Indexes...>::remove(int id)
+{
+    auto slot = this->positions.find(id);
+    if(slot == this->positions.end())
+        return;
+
+    std::size_t position = slot->second;
+    this->positions.erase(slot);
+    unlink(this->elements[position]);
+
+    if(position != this->elements.size() - 1) {
+        this->elements[position] = std::move(this->elements.back());
+        if(this->elements[position].getId() >= 0)
+            this->positions[this->elements[position].getId()] = position;
+    }
+    this->elements.pop_back();
+}
+
+/**
+ * Retire une entité si elle est égale à celle stockée (toutes les entités égales si elle n'a pas d'identifiant)
+ * @param element Entité à retirer
+ */
+template<typename T, typename... Indexes>
+void EntityStore<T, Indexes...>::remove(const T& element)
+{
+    if(element.getId() >= 0) {
+        const T* found = get(element.getId());
+        if(found && *found == element)
+            remove(element.getId());
+        return;
+    }
+
+    auto last = std::remove(this->elements.begin(), this->elements.end(), element);
+    if(last == this->elements.end())
+        return;
+    this->elements.erase(last, this->elements.end());
+    reindex();
+}
+
+/**
+ * Retire toutes les entités
+ */
+template<typename T, typename... Indexes>
+void EntityStore<T, Indexes...>::clear()
+{
+    this->elements.clear();
+    this->positions.clear();
+    std::apply([](auto&... index) { (index.clear(), ...); }, this->indexes);
+}
+
+/**
+ * Réserve la place pour un nombre d'entités (évite les réallocations lors d'un chargement)
+ * @param count Nombre d'entités attendues
+ */
+template<typename T, typename... Indexes>
+void EntityStore<T, Indexes...>::reserve(std::size_t count)
+{
+    this->elements.reserve(count);
+    this->positions.reserve(count);
+}
+
+/**
+ * Renvoie le nombre d'entités
+ * @return Nombre d'entités
+ */
+template<typename T, typename... Indexes>
+std::size_t EntityStore<T, Indexes...>::size() const
+{
+    return this->elements.size();
+}
+
+/**
+ * Indique si toutes les entités sont indexées (aucune n'est sans identifiant)
+ * @return Si les index couvrent toutes les entités
+ */
+template<typename T, typename... Indexes>
+bool EntityStore<T, Indexes...>::isIndexed() const
+{
+    return this->positions.size() == this->elements.size();
+}
+
+/**
+ * Renvoie l'entité (constante) avec un identifiant
+ * @param id Identifiant
+ * @return Entité (nullptr si non trouvée)
+ */
+template<typename T, typename... Indexes>
+const T* EntityStore<T, Indexes...>::get(int id) const
+{
+    auto slot = this->positions.find(id);
+    if(slot == this->positions.end())
+        return nullptr;
+    return &this->elements[slot->second];
+}
+
+/**
+ * Renvoie toutes les entités
+ * @return Entités (stockage contigu)
+ */
+template<typename T, typename... Indexes>
+const std::vector<T>& EntityStore<T, Indexes...>::data() const
+{
+    return this->elements;
+}
+
+/**
+ * Trie les entités (tri stable) puis reconstruit l'index des identifiants
+ * @param less Ordre des entités
+ */
+template<typename T, typename... Indexes>
+template<typename Less>
+void EntityStore<T, Indexes...>::sort(Less less)
+{
+    std::stable_sort(this->elements.begin(), this->elements.end(), less);
+    reindex();
+}
+
+/**
+ * Renvoie un index secondaire
+ * @tparam Index Type de l'index (doit faire partie de Indexes)
+ * @return Index
+ */
+template<typename T, typename... Indexes>
+template<typename Index>
+const Index& EntityStore<T, Indexes...>::index() const
+{
+    return std::get<Index>(this->indexes);
+}
+
+/**
+ * Vue sur les entités désignées par un intervalle d'index (identifiants ou éléments de DateIndex)
+ * @param range Fonction qui renvoie l'intervalle au début du parcours (paire d'itérateurs)
+ * @return Vue sur les entités, dans l'ordre de l'intervalle
+ */
+template<typename T, typename... Indexes>
+template<typename Range>
+View<T> EntityStore<T, Indexes...>::view(Range range) const
+{
+    const EntityStore* self = this;
+    return View<T>::byRange(range, [self](const auto& handle) { return self->get(idOf(handle)); });
+}
+
+/**
+ * Vue sur la fusion de plusieurs intervalles d'index triés (voir View::merge)
+ * @param runs Fonction qui renvoie les intervalles au début du parcours
+ * @param less Ordre des intervalles
+ * @return Vue sur les entités de tous les intervalles, dans l'ordre less
+ */
+template<typename T, typename... Indexes>
+template<typename Runs, typename Less>
+View<T> EntityStore<T, Indexes...>::merge(Runs runs, Less less) const
+{
+    const EntityStore* self = this;
+    return View<T>::merge(runs, [self](const auto& handle) { return self->get(idOf(handle)); }, less);
+}
+
+/**
+ * Itérateur constant sur la première entité
+ * @return Itérateur constant début
+ */
+template<typename T, typename... Indexes>
+typename EntityStore<T, Indexes...>::const_iterator EntityStore<T, Indexes...>::begin() const
+{
+    return this->elements.begin();
+}
+
+/**
+ * Itérateur constant de fin
+ * @return Itérateur constant fin
+ */
+template<typename T, typename... Indexes>
+typename EntityStore<T, Indexes...>::const_iterator EntityStore<T, Indexes...>::end() const
+{
+    return this->elements.end();
+}
+
+#endif // CDAA_ENTITYSTORE_H
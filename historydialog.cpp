@@ -9,12 +9,83 @@
 
 #include "historydialog.h"
 #include "ui_historydialog.h"
+#include <QTimer>
+#include <algorithm>
 
 /**
- * Affiche l'historique dans le QTableWidget en fonction des filtres
+ * Ajoute une interaction à la fin de la table (le tri de la table doit être désactivé)
+ * @param id Identifiant de l'interaction
+ * @param type Type de l'interaction
+ * @param description Description de l'interaction
+ * @param d Date de l'interaction
+ */
+void HistoryDialog::appendRow(int id, unsigned int type, const QString& description, const Date& d)
+{
+    ui->tableWidget->insertRow(ui->tableWidget->rowCount());
+    ui->tableWidget->setItem(ui->tableWidget->rowCount()-1, 0, new QTableWidgetItem(QString::number(id)) ); // Set data
+
+    if(type == ADD_CONTACT)
+        ui->tableWidget->setItem(ui->tableWidget->rowCount()-1, 1, new QTableWidgetItem("Création")); // Set data
+    else if(type == EDIT_CONTACT)
+        ui->tableWidget->setItem(ui->tableWidget->rowCount()-1, 1, new QTableWidgetItem("Edition")); // Set data
+    else
+        ui->tableWidget->setItem(ui->tableWidget->rowCount()-1, 1, new QTableWidgetItem("Suppression")); // Set data
+
+    ui->tableWidget->setItem(ui->tableWidget->rowCount()-1, 2, new QTableWidgetItem(description)); // Set data
+    ui->tableWidget->item(ui->tableWidget->rowCount()-1, 2)->setToolTip(description);
+
+    // Use QDate in item to sort correctly
+    QTableWidgetItem item;
+    item.setData(Qt::DisplayRole, QDate(d.getYear(), d.getMonth()+1, d.getDay()));
+    ui->tableWidget->setItem(ui->tableWidget->rowCount()-1, 3, new QTableWidgetItem(item)); // Set data
+}
+
+/**
+ * Affiche la page suivante de la sélection, puis programme la suivante au prochain tour de la boucle d'événements
+ * (la fenêtre reste réactive pendant le remplissage). Au premier appel sans filtre, les colonnes sont construites à
+ * partir de la vue : la première page, déjà affichée, en a été lue directement.
+ * @param page Numéro de l'affichage (rien n'est fait s'il a été remplacé par un autre)
+ */
+void HistoryDialog::showPage(unsigned int page)
+{
+    if(page != generation)
+        return;
+
+    if(!built)
+    {
+        interactions = InteractionColumns(source);
+        built = true;
+        interactions.select(InteractionColumns::Filter(), selection);
+    }
+
+    const std::size_t end = std::min(selection.size(), shown + PAGE_SIZE);
+    for(; shown < end; shown++)
+    {
+        const std::uint32_t row = selection[shown];
+        const std::string_view description = interactions.getDescription(row);
+        appendRow(interactions.getId(row), interactions.getType(row),
+                  QString::fromUtf8(description.data(), static_cast<int>(description.size())), interactions.getDate(row));
+    }
+
+    if(shown < selection.size())
+        QTimer::singleShot(0, this, [this, page]() { showPage(page); });
+    else
+        ui->tableWidget->setSortingEnabled(true); // Keeps the column chosen by the user
+}
+
+/**
+ * Affiche l'historique dans le QTableWidget en fonction des filtres.
+ * Tant qu'aucun filtre n'a été choisi, la première page est lue directement dans la vue (sans copier toutes les
+ * interactions) ; les filtres sont ensuite évalués sur les colonnes. Les pages suivantes sont ajoutées au fur et à
+ * mesure (voir showPage).
  */
 void HistoryDialog::refresh()
 {
+    generation++; // Pages of the previous display are dropped
+
+    // No sorting while filling (each insertion would sort the table again): rows come newest first
+    ui->tableWidget->setSortingEnabled(false);
+
     // Clear and set table header
     ui->tableWidget->clear();
     ui->tableWidget->setRowCount(0);
@@ -26,46 +97,44 @@ void HistoryDialog::refresh()
                 << "Date"
                 );
 
-    // for all interactions :
-    for(const auto& i: interactions)
-    {
-        // Check for type
-        if(type != -1 && i.getType() != static_cast<unsigned int>(type))
-            continue;
-
-        // Check for start
-        if(useFrom && i.getDate() < from)
-            continue;
-
-        //Check for end
-        if(useTo && i.getDate() > to)
-            continue;
-
-
-        // Display row
-        ui->tableWidget->insertRow(ui->tableWidget->rowCount());
-        ui->tableWidget->setItem(ui->tableWidget->rowCount()-1, 0, new QTableWidgetItem(QString::number(i.getId())) ); // Set data
+    // Stretch table
+    ui->tableWidget->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    ui->tableWidget->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
 
-        if(i.getType() == ADD_CONTACT)
-            ui->tableWidget->setItem(ui->tableWidget->rowCount()-1, 1, new QTableWidgetItem("Création")); // Set data
-        else if(i.getType() == EDIT_CONTACT)
-            ui->tableWidget->setItem(ui->tableWidget->rowCount()-1, 1, new QTableWidgetItem("Edition")); // Set data
+    shown = 0;
+    if(!built && type < 0 && !useFrom && !useTo)
+    {
+        // First page from the view, the columns are built on the next turn
+        for(const auto& i : source.limit(PAGE_SIZE))
+        {
+            appendRow(i.getId(), i.getType(), QString::fromStdString(i.getDescription()), i.getDate());
+            shown++;
+        }
+        if(shown < PAGE_SIZE)
+            ui->tableWidget->setSortingEnabled(true); // Everything is displayed
         else
-            ui->tableWidget->setItem(ui->tableWidget->rowCount()-1, 1, new QTableWidgetItem("Suppression")); // Set data
-
-        ui->tableWidget->setItem(ui->tableWidget->rowCount()-1, 2, new QTableWidgetItem(QString::fromStdString(i.getDescription()))); // Set data
-        ui->tableWidget->item(ui->tableWidget->rowCount()-1, 2)->setToolTip(i.getDescription().c_str());
+        {
+            const unsigned int page = generation;
+            QTimer::singleShot(0, this, [this, page]() { showPage(page); });
+        }
+        return;
+    }
 
-        // Use QDate in item to sort correctly
-        QTableWidgetItem item;
-        Date d = i.getDate();
-        item.setData(Qt::DisplayRole, QDate(d.getYear(), d.getMonth()+1, d.getDay()));
-        ui->tableWidget->setItem(ui->tableWidget->rowCount()-1, 3, new QTableWidgetItem(item)); // Set data
+    if(!built)
+    {
+        interactions = InteractionColumns(source);
+        built = true;
     }
 
-    // Stretch table
-    ui->tableWidget->setEditTriggers(QAbstractItemView::NoEditTriggers);
-    ui->tableWidget->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    // Filter the type and date columns, then display the selected rows
+    InteractionColumns::Filter filter;
+    filter.type = type;
+    if(useFrom)
+        filter.from = from.getEpoch();
+    if(useTo)
+        filter.to = to.getEpoch();
+    interactions.select(filter, selection); // Reuses the memory of the previous selection
+    showPage(generation);
 }
 
 /**
@@ -113,6 +182,9 @@ void HistoryDialog::on_endEditLine_textChanged(const QString &text)
 void HistoryDialog::init()
 {
     type = -1;
+    built = false;
+    shown = 0;
+    generation = 0;
 
     // ToolTips
     ui->startEditLine->setToolTip("dd/mm/yyy");
@@ -121,42 +193,47 @@ void HistoryDialog::init()
     useFrom = false;
     useTo = false;
 
+    ui->tableWidget->horizontalHeader()->setSortIndicator(3, Qt::DescendingOrder); // reverse order (already the view's)
     refresh();
-    ui->tableWidget->sortItems(3, Qt::DescendingOrder); // reverse order
 }
 
 /**
- * Constructeur de la classe avec une liste de contacts
- * @param is Liste de Contact de type Contacts
+ * Constructeur de la classe avec une vue sur des interactions (affichées dans l'ordre de la vue)
+ * @param view Interactions à afficher (la liste sous-jacente doit survivre à la fenêtre)
+ * @param title Titre de la fenêtre
  * @param parent Fenêtre parente
  */
-HistoryDialog::HistoryDialog(Contact c, QWidget *parent) :
+HistoryDialog::HistoryDialog(const View<Interaction>& view, const QString& title, QWidget *parent) :
     QDialog(parent),
-    interactions(c.getInteractions()),
+    source(view),
     ui(new Ui::HistoryDialog)
 {
     ui->setupUi(this);
     setModal(true);
-    setWindowTitle(QString::fromStdString("Historique: " + c.getFullName()));
+    setWindowTitle(title);
 
     init();
 }
 
 /**
- * Constructeur de la classe avec une liste d'interactions
- * @param is Liste d'Interaction de type Interactions
+ * Constructeur de la classe avec l'historique d'un contact (du plus récent au plus ancien)
+ * @param c Contact dont on affiche les interactions (doit survivre à la fenêtre)
  * @param parent Fenêtre parente
  */
-HistoryDialog::HistoryDialog(Interactions is, QWidget *parent) :
-    QDialog(parent),
-    interactions(is),
-    ui(new Ui::HistoryDialog)
+HistoryDialog::HistoryDialog(const Contact& c, QWidget *parent) :
+    HistoryDialog(c.getInteractions(true), QString::fromStdString("Historique: " + c.getFullName()), parent)
 {
-    ui->setupUi(this);
-    setModal(true);
-    setWindowTitle("Historique");
+}
 
-    init();
+/**
+ * Constructeur de la classe avec une liste d'interactions, lue dans son index des dates (du plus récent au plus
+ * ancien, sans tri)
+ * @param is Liste d'Interaction de type Interactions (doit survivre à la fenêtre)
+ * @param parent Fenêtre parente
+ */
+HistoryDialog::HistoryDialog(const Interactions& is, QWidget *parent) :
+    HistoryDialog(is.getInteractionsByDate(true), "Historique", parent)
+{
 }
 
 /**
@@ -13,6 +13,7 @@
 #include <QDialog>
 #include <QDate>
 #include "contact.h"
+#include "interactioncolumns.h"
 #include <ctime>
 #include "utils.h"
 
@@ -29,7 +30,14 @@ class HistoryDialog : public QDialog
 {
     Q_OBJECT
 private:
-    Interactions interactions; /*!< Liste des interactions à afficher. */
+    static constexpr std::size_t PAGE_SIZE = 500; /*!< Lignes ajoutées à la table par tour de la boucle d'événements */
+
+    View<Interaction> source; /*!< Interactions à afficher (vue paresseuse, lue pour la première page) */
+    InteractionColumns interactions; /*!< Copie en colonnes de la vue, filtrée sans lire les descriptions (construite après la première page) */
+    bool built; /*!< Colonnes construites */
+    std::vector<std::uint32_t> selection; /*!< Lignes des colonnes à afficher */
+    std::size_t shown; /*!< Nombre de lignes déjà affichées */
+    unsigned int generation; /*!< Numéro de l'affichage en cours (les pages d'un affichage remplacé sont abandonnées) */
 
     // Search
     int type; /*!< Type d'interactions à afficher */
@@ -40,13 +48,16 @@ private:
 
     bool checkForDate(std::string s, Date* d);
 
+    void appendRow(int id, unsigned int type, const QString& description, const Date& d);
+    void showPage(unsigned int page);
     void refresh();
 
     void init();
 
 public:
-    explicit HistoryDialog(Contact c, QWidget *parent = nullptr);
-    explicit HistoryDialog(Interactions is, QWidget *parent = nullptr);
+    HistoryDialog(const View<Interaction>& view, const QString& title, QWidget *parent = nullptr);
+    explicit HistoryDialog(const Contact& c, QWidget *parent = nullptr);
+    explicit HistoryDialog(const Interactions& is, QWidget *parent = nullptr);
     ~HistoryDialog();
 
 private slots:
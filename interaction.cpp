@@ -98,35 +98,20 @@ void Interaction::setDescription(std::string &description) {
     this->description = description;
 }
 
-std::string Interaction::getQuery(int mode) {
-
-    if(mode == DELETE)
-        return "DELETE FROM interaction WHERE id=" + std::to_string(this->id);
-
-    Utils::addSlashes(description);
-
-    switch(mode)
-    {
-        case UPDATE:
-            return "UPDATE interaction SET "
-                    "type="+std::to_string(type)+", "
-                    "description='"+description+"', "
-                    "date='" + date.getSqlFormat()+"' "
-                    "WHERE id="+std::to_string(id);
-        case CREATE:
-        return "INSERT INTO interaction "
-               "(owner_id, type, description, date) "
-               "VALUES (" +
-               std::to_string(ownerId) + ", " +
-               std::to_string(type) + ", "
-               "'"+ description + "', "
-               "'" + date.getSqlFormat() + "'"
-                ")";
-        default:
-            break;
-    }
+/**
+ * Renvoie si oui ou non l'interaction est urgente (sans date)
+ * @return Urgente ou non
+ */
+bool Interaction::isUrgent() const {
+    return this->urgent;
+}
 
-    return "";
+/**
+ * Définit si l'interaction est urgente (sans date)
+ * @param urgent Urgente ou non
+ */
+void Interaction::setUrgent(bool urgent) {
+    this->urgent = urgent;
 }
 
 /**
@@ -142,6 +127,7 @@ std::unordered_map<std::string, std::string> Interaction::toMap() const
         { "type", std::to_string(type) },
         { "description", description },
         { "date", date.getSqlFormat()},
+        { "urgent", urgent ? "1" : "0" },
     };
 }
 
@@ -157,6 +143,7 @@ std::ostream &operator<<(std::ostream &os, const Interaction &i) {
     os << "; type: " << i.type;
     os << "; description: '" << i.description;
     os << "'; date: " << i.date;
+    os << "; urgent: " << i.urgent;
     os << ">";
     return os;
 }
@@ -193,6 +180,7 @@ Interaction::Interaction() {
     this->date = Date();
     this->type = NONE;
     this->description = "";
+    this->urgent = false;
 }
 
 /**
@@ -209,6 +197,7 @@ Interaction::Interaction(int ownerId, unsigned int type, std::string& descriptio
     this->id = -1;
     this->description = description;
     this->date = date;
+    this->urgent = false;
 }
 
 /**
@@ -248,6 +237,7 @@ Interaction Interaction::fromMap(std::unordered_map<std::string, std::string> da
     i.setDescription(data.at("description"));
     i.setDate(Date(data.at("date")));
     i.setType(std::stoi(data.at("type")));
+    i.setUrgent(data.find("urgent") != data.end() && data.at("urgent") == "1");
 
     return i;
 }
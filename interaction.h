@@ -48,6 +48,7 @@ private:
     unsigned int type; /*!< Type de l'interaction (voir énumération types). */
     std::string description; /*!< Description textuelle de l'interaction. */
     Date date; /*!< Date de l'interaction. */
+    bool urgent; /*!< Interaction sans date, donc urgente. */
 
 public:
 
@@ -67,8 +68,10 @@ public:
     [[nodiscard]] const std::string& getDescription() const;
     void setDescription(std::string& description);
 
+    [[nodiscard]] bool isUrgent() const;
+    void setUrgent(bool urgent);
+
 
-    [[nodiscard]] std::string getQuery(int mode);
 
     std::unordered_map<std::string, std::string> toMap() const;
 
@@ -0,0 +1,296 @@
+/**
+ * @file interactioncolumns.cpp
+ *
+ * @brief Définition de la classe InteractionColumns (interactions stockées par colonnes, filtres vectorisés)
+ *
+ * @version 1.0
+ *
+ * @author LEESTMANS Richard
+ * @author COUDERT Nicolas
+ */
+
+#include "interactioncolumns.h"
+
+// The SIMD paths are compiled for their own target (no -mavx2 needed) and chosen at run time
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CDAA_COLUMNS_X86
+#include <immintrin.h>
+#endif
+
+/**
+ * Ajoute une interaction (une ligne) à la fin des colonnes
+ * @param i Interaction à ajouter
+ */
+void InteractionColumns::append(const Interaction& i)
+{
+    this->ids.push_back(i.getId());
+    this->owners.push_back(i.getOwnerId());
+    this->types.push_back(i.getType());
+    this->epochs.push_back(i.getDate().getEpoch());
+    this->urgents.push_back(i.isUrgent() ? 1 : 0);
+    this->descriptions += i.getDescription();
+    this->offsets.push_back(static_cast<std::uint32_t>(this->descriptions.size()));
+}
+
+/**
+ * Réserve la place pour un nombre de lignes (évite les réallocations au chargement)
+ * @param count Nombre de lignes
+ */
+void InteractionColumns::reserve(std::size_t count)
+{
+    this->ids.reserve(count);
+    this->owners.reserve(count);
+    this->types.reserve(count);
+    this->epochs.reserve(count);
+    this->urgents.reserve(count);
+    this->offsets.reserve(count + 1);
+}
+
+/**
+ * Retire toutes les lignes
+ */
+void InteractionColumns::clear()
+{
+    this->ids.clear();
+    this->owners.clear();
+    this->types.clear();
+    this->epochs.clear();
+    this->urgents.clear();
+    this->descriptions.clear();
+    this->offsets.assign(1, 0);
+}
+
+/**
+ * Renvoie le nombre de lignes (interactions)
+ * @return Nombre de lignes
+ */
+std::size_t InteractionColumns::size() const
+{
+    return this->ids.size();
+}
+
+/**
+ * Renvoie l'identifiant d'une ligne
+ * @param row Ligne
+ * @return Identifiant de l'interaction
+ */
+int InteractionColumns::getId(std::size_t row) const
+{
+    return this->ids[row];
+}
+
+/**
+ * Renvoie le propriétaire d'une ligne
+ * @param row Ligne
+ * @return Identifiant du propriétaire
+ */
+int InteractionColumns::getOwnerId(std::size_t row) const
+{
+    return this->owners[row];
+}
+
+/**
+ * Renvoie le type d'une ligne
+ * @param row Ligne
+ * @return Type de l'interaction (voir énumération types)
+ */
+unsigned int InteractionColumns::getType(std::size_t row) const
+{
+    return this->types[row];
+}
+
+/**
+ * Renvoie la date d'une ligne
+ * @param row Ligne
+ * @return Date de l'interaction
+ */
+Date InteractionColumns::getDate(std::size_t row) const
+{
+    return Date::fromEpoch(this->epochs[row]);
+}
+
+/**
+ * Renvoie la description d'une ligne (sans copie)
+ * @param row Ligne
+ * @return Description, valide tant que les colonnes ne sont pas modifiées
+ */
+std::string_view InteractionColumns::getDescription(std::size_t row) const
+{
+    return std::string_view(this->descriptions).substr(this->offsets[row], this->offsets[row + 1] - this->offsets[row]);
+}
+
+/**
+ * Indique si une ligne est urgente
+ * @param row Ligne
+ * @return Si l'interaction est urgente
+ */
+bool InteractionColumns::isUrgent(std::size_t row) const
+{
+    return this->urgents[row] != 0;
+}
+
+/**
+ * Évalue un filtre ligne par ligne, sans branchement, à partir d'une ligne donnée jusqu'à la fin.
+ * @param filter Filtre à appliquer
+ * @param first Première ligne à évaluer
+ * @param out Lignes sélectionnées (doit pouvoir contenir size() - first lignes)
+ * @return Nombre de lignes sélectionnées
+ */
+std::size_t InteractionColumns::selectScalar(const Filter& filter, std::size_t first, std::uint32_t* out) const
+{
+    const bool anyType = filter.type < 0;
+    const auto type = static_cast<std::uint32_t>(filter.type);
+    std::size_t count = 0;
+    for(std::size_t row = first; row < size(); row++) {
+        out[count] = static_cast<std::uint32_t>(row);
+        count += (this->epochs[row] >= filter.from) & (this->epochs[row] <= filter.to)
+                 & (anyType | (this->types[row] == type));
+    }
+    return count;
+}
+
+#ifdef CDAA_COLUMNS_X86
+/**
+ * Évalue un filtre par blocs de 4 lignes avec AVX2, jusqu'au dernier bloc complet
+ * @param filter Filtre à appliquer
+ * @param epochs Colonne des dates
+ * @param types Colonne des types
+ * @param size Nombre de lignes
+ * @param row Première ligne à évaluer, puis première ligne non évaluée
+ * @param out Lignes sélectionnées
+ * @return Nombre de lignes sélectionnées
+ */
+__attribute__((target("avx2")))
+static std::size_t selectAvx2(const InteractionColumns::Filter& filter, const std::int64_t* epochs,
+                              const std::uint32_t* types, std::size_t size, std::size_t& row, std::uint32_t* out)
+{
+    const __m256i from = _mm256_set1_epi64x(filter.from);
+    const __m256i to = _mm256_set1_epi64x(filter.to);
+    const __m128i type = _mm_set1_epi32(filter.type);
+    std::size_t count = 0;
+    for(; row + 4 <= size; row += 4) {
+        const __m256i epoch = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(epochs + row));
+        const __m256i outside = _mm256_or_si256(_mm256_cmpgt_epi64(from, epoch), _mm256_cmpgt_epi64(epoch, to));
+        int keep = ~_mm256_movemask_pd(_mm256_castsi256_pd(outside)) & 0xF;
+        if(filter.type >= 0) {
+            const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(types + row));
+            keep &= _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(block, type)));
+        }
+        for(int lane = 0; lane < 4; lane++) {
+            out[count] = static_cast<std::uint32_t>(row + lane);
+            count += (keep >> lane) & 1;
+        }
+    }
+    return count;
+}
+
+/**
+ * Évalue un filtre par blocs de 2 lignes avec SSE4.2, jusqu'au dernier bloc complet
+ * @param filter Filtre à appliquer
+ * @param epochs Colonne des dates
+ * @param types Colonne des types
+ * @param size Nombre de lignes
+ * @param row Première ligne à évaluer, puis première ligne non évaluée
+ * @param out Lignes sélectionnées
+ * @return Nombre de lignes sélectionnées
+ */
+__attribute__((target("sse4.2")))
+static std::size_t selectSse42(const InteractionColumns::Filter& filter, const std::int64_t* epochs,
+                               const std::uint32_t* types, std::size_t size, std::size_t& row, std::uint32_t* out)
+{
+    const __m128i from = _mm_set1_epi64x(filter.from);
+    const __m128i to = _mm_set1_epi64x(filter.to);
+    const __m128i type = _mm_set1_epi32(filter.type);
+    std::size_t count = 0;
+    for(; row + 2 <= size; row += 2) {
+        const __m128i epoch = _mm_loadu_si128(reinterpret_cast<const __m128i*>(epochs + row));
+        const __m128i outside = _mm_or_si128(_mm_cmpgt_epi64(from, epoch), _mm_cmpgt_epi64(epoch, to));
+        int keep = ~_mm_movemask_pd(_mm_castsi128_pd(outside)) & 0x3;
+        if(filter.type >= 0) {
+            const __m128i block = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(types + row));
+            keep &= _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(block, type))) & 0x3;
+        }
+        for(int lane = 0; lane < 2; lane++) {
+            out[count] = static_cast<std::uint32_t>(row + lane);
+            count += (keep >> lane) & 1;
+        }
+    }
+    return count;
+}
+#endif
+
+/**
+ * Renvoie les meilleures instructions disponibles sur le processeur (détectées une seule fois)
+ * @return AVX2_PATH, SSE42_PATH ou SCALAR_PATH
+ */
+InteractionColumns::Path InteractionColumns::bestPath()
+{
+#ifdef CDAA_COLUMNS_X86
+    static const Path best = __builtin_cpu_supports("avx2") ? AVX2_PATH
+                             : __builtin_cpu_supports("sse4.2") ? SSE42_PATH : SCALAR_PATH;
+    return best;
+#else
+    return SCALAR_PATH;
+#endif
+}
+
+/**
+ * Renvoie les lignes qui vérifient un filtre (type et intervalle de dates), dans l'ordre des colonnes.
+ * @param filter Filtre à appliquer
+ * @param path Instructions à utiliser (voir select(filter, selection, path))
+ * @return Numéros des lignes sélectionnées
+ */
+std::vector<std::uint32_t> InteractionColumns::select(const Filter& filter, Path path) const
+{
+    std::vector<std::uint32_t> selection;
+    select(filter, selection, path);
+    return selection;
+}
+
+/**
+ * Remplit une liste avec les lignes qui vérifient un filtre (type et intervalle de dates), dans l'ordre des colonnes.
+ * Les colonnes des dates et des types sont comparées par blocs de 4 lignes (AVX2) ou de 2 lignes (SSE4.2), la fin
+ * des colonnes (ou toutes les lignes sans ces instructions) ligne par ligne. La mémoire de la liste est réutilisée
+ * d'un filtre à l'autre.
+ * @param filter Filtre à appliquer
+ * @param selection Numéros des lignes sélectionnées (remplacés)
+ * @param path Instructions à utiliser (par défaut les meilleures du processeur ; remplacées par celles-ci si le
+ * processeur ne les a pas)
+ */
+void InteractionColumns::select(const Filter& filter, std::vector<std::uint32_t>& selection, Path path) const
+{
+    const Path best = bestPath();
+    if(path == BEST_PATH || path > best)
+        path = best;
+
+    selection.resize(size());
+    std::size_t count = 0;
+    std::size_t row = 0;
+
+#ifdef CDAA_COLUMNS_X86
+    if(path == AVX2_PATH)
+        count = selectAvx2(filter, this->epochs.data(), this->types.data(), size(), row, selection.data());
+    else if(path == SSE42_PATH)
+        count = selectSse42(filter, this->epochs.data(), this->types.data(), size(), row, selection.data());
+#endif
+
+    count += selectScalar(filter, row, selection.data() + count);
+    selection.resize(count);
+}
+
+/**
+ * Constructeur d'un ensemble de colonnes vide
+ */
+InteractionColumns::InteractionColumns() : offsets(1, 0)
+{
+}
+
+/**
+ * Constructeur à partir des interactions d'une vue (copiées dans l'ordre de la vue)
+ * @param interactions Interactions à copier
+ */
+InteractionColumns::InteractionColumns(const View<Interaction>& interactions) : InteractionColumns()
+{
+    for(const auto& i : interactions)
+        append(i);
+}
@@ -0,0 +1,87 @@
+/**
+ * @file interactioncolumns.h
+ *
+ * @brief Déclaration de la classe InteractionColumns (interactions stockées par colonnes, filtres vectorisés)
+ *
+ * @author LEESTMANS Richard
+ * @author COUDERT Nicolas
+ */
+
+#ifndef CDAA_INTERACTIONCOLUMNS_H
+#define CDAA_INTERACTIONCOLUMNS_H
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "interaction.h"
+#include "view.h"
+
+/**
+ * Copie en colonnes (struct of arrays) d'un ensemble d'interactions, destinée à l'affichage et aux statistiques.
+ * Chaque champ est stocké dans un tableau contigu (identifiants, propriétaires, types, dates) et les descriptions
+ * sont mises bout à bout dans une seule chaîne : filtrer par type ou par date ne lit que les colonnes concernées.
+ * Les filtres sont évalués par blocs avec des instructions SIMD (AVX2 ou SSE4.2 selon le processeur, détecté à
+ * l'exécution, boucle scalaire sinon) et produisent une liste de lignes sélectionnées.
+ * Les colonnes sont une copie : elles ne suivent pas les modifications de la liste d'origine.
+ * \brief Interactions stockées par colonnes
+ */
+class InteractionColumns
+{
+public:
+    /**
+     * Filtre sur les interactions (toutes les conditions doivent être vérifiées)
+     */
+    struct Filter
+    {
+        int type = -1; /*!< Type recherché (-1: tous les types) */
+        std::int64_t from = std::numeric_limits<std::int64_t>::min(); /*!< Date minimale incluse (Date::getEpoch()) */
+        std::int64_t to = std::numeric_limits<std::int64_t>::max(); /*!< Date maximale incluse (Date::getEpoch()) */
+    };
+
+    /**
+     * Instructions utilisées pour évaluer un filtre
+     */
+    enum Path
+    {
+        BEST_PATH, /*!< Les meilleures disponibles sur le processeur */
+        SCALAR_PATH, /*!< Boucle scalaire */
+        SSE42_PATH, /*!< SSE4.2, 2 lignes par itération */
+        AVX2_PATH /*!< AVX2, 4 lignes par itération */
+    };
+
+private:
+    std::vector<std::int32_t> ids; /*!< Identifiants */
+    std::vector<std::int32_t> owners; /*!< Identifiants des propriétaires */
+    std::vector<std::uint32_t> types; /*!< Types (voir énumération types) */
+    std::vector<std::int64_t> epochs; /*!< Dates (Date::getEpoch()) */
+    std::vector<std::uint8_t> urgents; /*!< Interactions urgentes (0 ou 1) */
+    std::string descriptions; /*!< Descriptions mises bout à bout */
+    std::vector<std::uint32_t> offsets; /*!< Début de chaque description dans descriptions (une de plus que de lignes) */
+
+    std::size_t selectScalar(const Filter& filter, std::size_t first, std::uint32_t* out) const;
+
+public:
+    // Voir interactioncolumns.cpp pour la documentation des méthodes
+    void append(const Interaction& i);
+    void reserve(std::size_t count);
+    void clear();
+    [[nodiscard]] std::size_t size() const;
+
+    [[nodiscard]] int getId(std::size_t row) const;
+    [[nodiscard]] int getOwnerId(std::size_t row) const;
+    [[nodiscard]] unsigned int getType(std::size_t row) const;
+    [[nodiscard]] Date getDate(std::size_t row) const;
+    [[nodiscard]] std::string_view getDescription(std::size_t row) const;
+    [[nodiscard]] bool isUrgent(std::size_t row) const;
+
+    [[nodiscard]] std::vector<std::uint32_t> select(const Filter& filter, Path path = BEST_PATH) const;
+    void select(const Filter& filter, std::vector<std::uint32_t>& selection, Path path = BEST_PATH) const;
+    [[nodiscard]] static Path bestPath();
+
+    InteractionColumns();
+    explicit InteractionColumns(const View<Interaction>& interactions);
+};
+
+#endif // CDAA_INTERACTIONCOLUMNS_H
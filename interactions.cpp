@@ -13,17 +13,20 @@
  */
 
 #include "interactions.h"
+#include <memory>
 
 /**
- * Ajoute une interaction à la liste modélisée
+ * Ajoute une interaction à la liste modélisée.
+ * Si une interaction avec le même identifiant existe déjà, elle est remplacée.
  * @param i Interaction à ajouter à la liste
  */
 void Interactions::addInteraction(const Interaction& i) {
-    this->interactions.push_back(i);
+    this->interactions.add(i);
 }
 
 /**
- * Tri les interactions par date du plus ancien au plus récent (par défaut).
+ * Tri les interactions de la liste par date du plus ancien au plus récent (par défaut).
+ * Les index, eux, sont toujours triés par date.
  * @param reverse Par défaut false, si True: les dates seront rangés de la plus récentes à la plus ancienne.
  */
 void Interactions::sortByDate(bool reverse) {
@@ -33,6 +36,14 @@ void Interactions::sortByDate(bool reverse) {
         this->interactions.sort([](const Interaction &i, const Interaction &i1) {return i.getDate() < i1.getDate();});
 }
 
+/**
+ * Réserve la place pour un nombre de Interaction donné (évite les réallocations lors d'un chargement)
+ * @param count Nombre de Interaction attendus
+ */
+void Interactions::reserve(std::size_t count) {
+    this->interactions.reserve(count);
+}
+
 /**
  * Vide l'intégralité de la liste modélisée
  */
@@ -40,49 +51,76 @@ void Interactions::clear() {
     this->interactions.clear();
 }
 
+/**
+ * Échange le contenu de deux listes (et leurs index), sans copie
+ * @param other Autre liste
+ */
+void Interactions::swap(Interactions& other) {
+    std::swap(this->interactions, other.interactions);
+}
 
 /**
- * Renvoie une interaction avec son identifiant.
+ * Renvoie une interaction (constante) avec son identifiant.
  * @param id Identifiant de l'interaction voulue.
  * @return Interaction (nullptr si non trouvée).
  */
-Interaction* Interactions::getInteraction(int id) {
-    for(Interaction& i : this->interactions)
-        if(i.getId() == id)
-            return &i;
-    return nullptr;
+const Interaction* Interactions::getInteraction(int id) const {
+    return this->interactions.get(id);
 }
 
 /**
- * Renvoie le nombre d'interactions dans la liste.
- * @return Nombre d'interactions.
+ * Renvoie une vue sur les interactions d'un propriétaire (Contact), sans copie, par ordre chronologique
+ * @param ownerId Identifiant du propriétaire (-1: interactions non reliées à un contact)
+ * @param reverse Du plus récent au plus ancien ? (false par défaut)
+ * @return Vue sur les interactions du propriétaire
  */
-unsigned int Interactions::size() const{
-    return static_cast<unsigned int>(this->interactions.size());
+View<Interaction> Interactions::getInteractionsOf(int ownerId, bool reverse) const {
+    const Store* store = &this->interactions;
+    if(reverse)
+        return store->view([store, ownerId]() {
+            return DateIndex::reverse(store->index<ByOwner>().of(ownerId).all());
+        });
+    return store->view([store, ownerId]() { return store->index<ByOwner>().of(ownerId).all(); });
 }
 
 /**
- * Itérateur classique: premier élément.
- * @return Itérateur fixé au début de la liste.
+ * Renvoie une vue sur les interactions d'un propriétaire (Contact) entre deux dates, par ordre chronologique
+ * @param ownerId Identifiant du propriétaire (-1: interactions non reliées à un contact)
+ * @param to Date de début de recherche
+ * @param from Date de fin de recherche
+ * @return Vue sur les interactions concernées
  */
-Interactions::iterator Interactions::begin() {
-    return this->interactions.begin();
+View<Interaction> Interactions::getInteractionsOfBetween(int ownerId, const Date &to, const Date &from) const {
+    const Store* store = &this->interactions;
+    const std::int64_t first = to.getEpoch(), last = from.getEpoch();
+    return store->view([store, ownerId, first, last]() {
+        return store->index<ByOwner>().of(ownerId).between(first, last);
+    });
 }
 
 /**
- * Itérateur constant: premier élément.
- * @return  Itérateur constant fixé au début de la liste.
+ * Renvoie le nombre d'interactions d'un propriétaire (Contact)
+ * @param ownerId Identifiant du propriétaire
+ * @return Nombre d'interactions
  */
-Interactions::const_iterator Interactions::begin() const {
-    return this->interactions.begin();
+std::size_t Interactions::countOf(int ownerId) const {
+    return this->interactions.index<ByOwner>().of(ownerId).size();
 }
 
 /**
- * Itérateur classique marquant la fin de la liste.
- * @return Itérateur fixé sur le dernier élément de la liste.
+ * Renvoie le nombre d'interactions dans la liste.
+ * @return Nombre d'interactions.
  */
-Interactions::iterator Interactions::end() {
-    return this->interactions.end();
+unsigned int Interactions::size() const{
+    return static_cast<unsigned int>(this->interactions.size());
+}
+
+/**
+ * Itérateur constant: premier élément.
+ * @return  Itérateur constant fixé au début de la liste.
+ */
+Interactions::const_iterator Interactions::begin() const {
+    return this->interactions.begin();
 }
 
 /**
@@ -94,19 +132,16 @@ Interactions::const_iterator Interactions::end() const {
 }
 
 /**
- * Retire le premier élément trouvé avec l'identifiant passé en paramètre
+ * Retire l'élément avec l'identifiant passé en paramètre.
+ * Le dernier élément prend la place de celui supprimé (l'ordre de la liste n'est pas conservé).
  * @param id Identifiant de l'interaction à supprimer
  */
 void Interactions::remove(int id) {
-    for(const auto& i : this->interactions)
-        if(i.getId() == id) {
-            this->interactions.remove(i);
-            return; // Return to prevent access violation
-        }
+    this->interactions.remove(id);
 }
 
 /**
- * Retire l'élément i de la liste
+ * Retire l'élément i de la liste (tous les éléments égaux s'il n'a pas d'identifiant)
  * @param i Interaction a retirer
  */
 void Interactions::remove(const Interaction& i) {
@@ -114,30 +149,72 @@ void Interactions::remove(const Interaction& i) {
 }
 
 /**
- * Renvoie un objet Interactions contant les interactions de cette liste se trouvant entre deux dates
+ * Renvoie une vue sur les interactions de cette liste se trouvant entre deux dates (sans copie, évaluée au parcours).
+ * Les interactions sont lues dans l'index des dates, par ordre chronologique ; la liste n'est parcourue entièrement
+ * que si elle contient des interactions sans identifiant (non indexées).
  * @param to Date de début de recherche
  * @param from Date de fin de recherche
- * @return Liste d'interactions se trouvant entre les deux dates
+ * @return Vue sur les interactions se trouvant entre les deux dates
  */
-Interactions Interactions::getInteractionsBetween(Date &to, Date &from) {
-    Interactions is{};
-    for(const auto& i: this->interactions)
-        if(i.getDate() >= to && i.getDate() <= from)
-            is.addInteraction(i);
-    return is;
+View<Interaction> Interactions::getInteractionsBetween(const Date &to, const Date &from) const {
+    if(!this->interactions.isIndexed())
+        return View<Interaction>::of(this->interactions).where([to, from](const Interaction& i) {
+            return i.getDate() >= to && i.getDate() <= from;
+        });
+
+    const Store* store = &this->interactions;
+    const std::int64_t first = to.getEpoch(), last = from.getEpoch();
+    return store->view([store, first, last]() { return store->index<ByDate>().get().between(first, last); });
 }
 
 /**
- * Retourne les interactions sans date, et donc importantes
- * @return Interactions sans date.
+ * Renvoie une vue sur toutes les interactions (avec identifiant) par ordre chronologique, lue dans l'index des dates :
+ * rien n'est copié ni trié.
+ * @param reverse Du plus récent au plus ancien ? (false par défaut)
+ * @return Vue chronologique sur les interactions
  */
-Interactions Interactions::getUrgentInteractions() {
-    Interactions is;
-    for(auto& i: this->interactions) {
-        if(i.getDate().getTotalSeconds() == -1)
-            is.addInteraction(i);
-    }
-    return is;
+View<Interaction> Interactions::getInteractionsByDate(bool reverse) const {
+    const Store* store = &this->interactions;
+    if(reverse)
+        return store->view([store]() { return DateIndex::reverse(store->index<ByDate>().get().all()); });
+    return store->view([store]() { return store->index<ByDate>().get().all(); });
+}
+
+/**
+ * Renvoie une vue chronologique sur les interactions de plusieurs propriétaires.
+ * Les index (déjà triés) de chaque propriétaire sont fusionnés au fur et à mesure du parcours (fusion k-aire) : le
+ * premier élément est disponible sans trier l'ensemble.
+ * @param ownerIds Identifiants des propriétaires
+ * @param reverse Du plus récent au plus ancien ? (false par défaut)
+ * @return Vue chronologique sur les interactions des propriétaires
+ */
+View<Interaction> Interactions::getInteractionsByDate(std::vector<int> ownerIds, bool reverse) const {
+    const Store* store = &this->interactions;
+    auto owners = std::make_shared<const std::vector<int>>(std::move(ownerIds));
+    if(reverse)
+        return store->merge(
+            [store, owners]() {
+                std::vector<DateIndex::ReverseRange> runs;
+                for(const auto& run : store->index<ByOwner>().runsOf(*owners))
+                    runs.push_back(DateIndex::reverse(run));
+                return runs;
+            },
+            DateIndex::After());
+    return store->merge([store, owners]() { return store->index<ByOwner>().runsOf(*owners); }, DateIndex::Before());
+}
+
+/**
+ * Retourne une vue sur les interactions sans date, et donc importantes.
+ * Les interactions urgentes sont lues dans leur index (O(k)) ; la liste n'est parcourue entièrement que si elle
+ * contient des interactions sans identifiant (non indexées).
+ * @return Vue sur les interactions sans date.
+ */
+View<Interaction> Interactions::getUrgentInteractions() const {
+    if(!this->interactions.isIndexed())
+        return View<Interaction>::of(this->interactions).where([](const Interaction& i) { return i.isUrgent(); });
+
+    const Store* store = &this->interactions;
+    return store->view([store]() { return store->index<UrgentIds>().all(); });
 }
 
 /**
@@ -169,6 +246,7 @@ Interactions &operator+=(Interactions &is, const Interaction &i) {
  * @return Listes concaténées
  */
 Interactions &operator+=(Interactions &is, const Interactions &i) {
+    is.interactions.reserve(is.interactions.size() + i.interactions.size());
     for(auto& interaction : i.interactions)
         is.addInteraction(interaction);
     return is;
@@ -214,16 +292,14 @@ std::ostream& operator<<(std::ostream& os, const Interactions& is) {
 /**
  * Constructeur par défaut
  */
-Interactions::Interactions() {
-    this->interactions = std::list<Interaction>();
-}
+Interactions::Interactions() = default;
 
 /**
  * Constructeur avec une interaction
  * @param i Interaction utilisée pour initialiser la liste
  */
 Interactions::Interactions(const Interaction& i) {
-    this->interactions = std::list<Interaction>{i};
+    addInteraction(i);
 }
 
 /**
@@ -231,9 +307,9 @@ Interactions::Interactions(const Interaction& i) {
  * @param interactions intercations à copier dans la nouvelle structeur
  */
 Interactions::Interactions(const std::list<Interaction>& interactions) {
-    this->interactions = std::list<Interaction>();
+    this->interactions.reserve(interactions.size());
     for(const Interaction& i : interactions)
-        this->interactions.push_back(i);
+        addInteraction(i);
 }
 
 
@@ -16,15 +16,26 @@
 #define CDAA_INTERACTIONS_H
 
 #include <list>
+#include <vector>
+#include <unordered_map>
+#include "dateindex.h"
+#include "entitystore.h"
 #include "interaction.h"
+#include "view.h"
 
 /**
  * Classe modélisant une liste d'interactions permettant des opérations supplémentaires par rapport à la list de la bibliothèque std
+ * Les interactions sont stockées de manière contiguë et indexées par identifiant, par date et par propriétaire
+ * (Contact), voir EntityStore : la liste de l'application contient chaque interaction une seule fois, un Contact y accède par
+ * getInteractionsOf(). Les recherches entre deux dates ne parcourent que les interactions concernées.
+ * Seules les interactions qui ont un identifiant (>= 0) sont indexées. L'identifiant ou le propriétaire d'une
+ * interaction de la liste se modifie en la remplaçant (addInteraction) : getInteraction() et les itérateurs sont constants.
  * \brief Liste d'interactions
  */
 class Interactions {
 private:
-    std::list<Interaction> interactions;/*!< Listes des interactions. */
+    using Store = EntityStore<Interaction, ByDate, ByOwner, UrgentIds>; /*!< Index utilisés par la liste */
+    Store interactions; /*!< Listes des interactions (stockage contigu et index). */
 
 public:
     // Voir interactions.cpp pour la documentation des méthodes
@@ -35,19 +46,23 @@ public:
     void remove(const Interaction& i);
 
     void clear();
+    void reserve(std::size_t count);
+    void swap(Interactions& other);
 
     [[nodiscard]] unsigned int size() const;
 
-    [[nodiscard]] Interaction* getInteraction(int id);
-    [[nodiscard]] Interactions getInteractionsBetween(Date& to, Date& from);
-    [[nodiscard]] Interactions getUrgentInteractions();
+    [[nodiscard]] const Interaction* getInteraction(int id) const;
+    [[nodiscard]] View<Interaction> getInteractionsOf(int ownerId, bool reverse=false) const;
+    [[nodiscard]] std::size_t countOf(int ownerId) const;
+    [[nodiscard]] View<Interaction> getInteractionsOfBetween(int ownerId, const Date& to, const Date& from) const;
+    [[nodiscard]] View<Interaction> getInteractionsBetween(const Date& to, const Date& from) const;
+    [[nodiscard]] View<Interaction> getInteractionsByDate(bool reverse=false) const;
+    [[nodiscard]] View<Interaction> getInteractionsByDate(std::vector<int> ownerIds, bool reverse=false) const;
+    [[nodiscard]] View<Interaction> getUrgentInteractions() const;
 
 
-    using iterator = std::list<Interaction>::iterator;
-    using const_iterator = std::list<Interaction>::const_iterator;
-    iterator begin();
+    using const_iterator = std::vector<Interaction>::const_iterator;
     const_iterator begin() const;
-    iterator end();
     const_iterator end() const;
 
     // Surcharges d'opérateurs
@@ -11,19 +11,18 @@
 
 #include "mainwindow.h"
 #include "ui_mainwindow.h"
+#include <algorithm>
 #include <unordered_map>
 
 /**
- * Rafraichit la table des contacts entière.
- * La dernière colonne est un bouton qui affiche un menu avec 3 boutons (QAction) qui utilisent les fonctions anonymes afin de relier sur 3 méthodes:
- *      * editContact(id)
- *      * deleteContact(id)
- *      * historyContact(id)
+ * Rafraichit la table des contacts entière (une ligne par contact, voir appendContactRow).
  */
 void MainWindow::refresh()
 {
     ui->tableWidget->clear();
     ui->tableWidget->setRowCount(0);
+    contactRows.clear();
+    visibleContacts.clear();
     ui->tableWidget->setHorizontalHeaderLabels(
                 QStringList()
                 << "Identifiant"
@@ -33,59 +32,100 @@ void MainWindow::refresh()
                 << "Création"
                 << "Actions"
                 );
-    for(auto& c: this->contacts)
+    const bool sorting = ui->tableWidget->isSortingEnabled();
+    ui->tableWidget->setSortingEnabled(false); // Rows would move while being filled
+    for(const auto& c: dbInterface.getContacts())
     {
-        // Row
-        ui->tableWidget->insertRow(ui->tableWidget->rowCount());
-        ui->tableWidget->setItem(ui->tableWidget->rowCount()-1, 0, new QTableWidgetItem(QString::number(c.getId())) ); // Set data
-        ui->tableWidget->setItem(ui->tableWidget->rowCount()-1, 1, new QTableWidgetItem(c.getFullName().c_str())); // Set data
-         ui->tableWidget->item(ui->tableWidget->rowCount()-1, 1)->setToolTip(c.getFullName().c_str());
-        ui->tableWidget->setItem(ui->tableWidget->rowCount()-1, 2, new QTableWidgetItem(c.getCompany().c_str())); // Set data
-        ui->tableWidget->item(ui->tableWidget->rowCount()-1, 2)->setToolTip(c.getCompany().c_str());
-        ui->tableWidget->setItem(ui->tableWidget->rowCount()-1, 3,  new QTableWidgetItem(c.getPhone().c_str())); // Set data
-        ui->tableWidget->item(ui->tableWidget->rowCount()-1, 3)->setToolTip(c.getPhone().c_str());
-        QTableWidgetItem item;
-        Date d = c.getCreationDate();
-        item.setData(Qt::DisplayRole, QDate(d.getYear(), d.getMonth()+1, d.getDay()));
-        ui->tableWidget->setItem(ui->tableWidget->rowCount()-1, 4,  new QTableWidgetItem(item)); // Set data
-
-        // Last button with QMenu
-        QPushButton* btn_edit = new QPushButton();
-        btn_edit->setText("...");
-        QMenu* menu = new QMenu();
-        menu->addAction("Editer", [this, c](bool){editContact(c.getId());});
-        menu->addAction("Supprimer", [this, c](bool){deleteContact(c.getId());});
-        menu->addAction("Historique", [this, c](bool){historyContact(c.getId());});
-        btn_edit->setMenu(menu);
-
-        ui->tableWidget->setCellWidget(ui->tableWidget->rowCount()-1, 5, btn_edit); // Add button
+        appendContactRow(c);
+        visibleContacts.push_back(c.getId());
     }
+    std::sort(visibleContacts.begin(), visibleContacts.end());
+    ui->tableWidget->setSortingEnabled(sorting);
     ui->tableWidget->setEditTriggers(QAbstractItemView::NoEditTriggers);
     ui->tableWidget->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
 }
 
+/**
+ * Ajoute la ligne d'un contact à la fin de la table (le tri de la table doit être désactivé). La ligne est visible :
+ * l'appelant ajoute le contact à visibleContacts.
+ * La dernière colonne est un bouton qui affiche un menu avec 3 boutons (QAction) qui utilisent les fonctions anonymes afin de relier sur 3 méthodes:
+ *      * editContact(id)
+ *      * deleteContact(id)
+ *      * historyContact(id)
+ * @param c Contact à afficher
+ */
+void MainWindow::appendContactRow(const Contact& c)
+{
+    // Row
+    ui->tableWidget->insertRow(ui->tableWidget->rowCount());
+    QTableWidgetItem* idItem = new QTableWidgetItem(QString::number(c.getId()));
+    ui->tableWidget->setItem(ui->tableWidget->rowCount()-1, 0, idItem); // Set data
+    contactRows[c.getId()] = idItem;
+    ui->tableWidget->setItem(ui->tableWidget->rowCount()-1, 1, new QTableWidgetItem(c.getFullName().c_str())); // Set data
+    ui->tableWidget->item(ui->tableWidget->rowCount()-1, 1)->setToolTip(c.getFullName().c_str());
+    ui->tableWidget->setItem(ui->tableWidget->rowCount()-1, 2, new QTableWidgetItem(c.getCompany().c_str())); // Set data
+    ui->tableWidget->item(ui->tableWidget->rowCount()-1, 2)->setToolTip(c.getCompany().c_str());
+    ui->tableWidget->setItem(ui->tableWidget->rowCount()-1, 3,  new QTableWidgetItem(c.getPhone().c_str())); // Set data
+    ui->tableWidget->item(ui->tableWidget->rowCount()-1, 3)->setToolTip(c.getPhone().c_str());
+    QTableWidgetItem item;
+    Date d = c.getCreationDate();
+    item.setData(Qt::DisplayRole, QDate(d.getYear(), d.getMonth()+1, d.getDay()));
+    ui->tableWidget->setItem(ui->tableWidget->rowCount()-1, 4,  new QTableWidgetItem(item)); // Set data
+
+    // Last button with QMenu
+    QPushButton* btn_edit = new QPushButton();
+    btn_edit->setText("...");
+    QMenu* menu = new QMenu();
+    const int id = c.getId();
+    menu->addAction("Editer", [this, id](bool){editContact(id);});
+    menu->addAction("Supprimer", [this, id](bool){deleteContact(id);});
+    menu->addAction("Historique", [this, id](bool){historyContact(id);});
+    btn_edit->setMenu(menu);
+
+    ui->tableWidget->setCellWidget(ui->tableWidget->rowCount()-1, 5, btn_edit); // Add button
+}
+
+/**
+ * Affiche ou cache la ligne d'un contact de la table
+ * @param id Identifiant du contact
+ * @param visible Afficher la ligne ?
+ */
+void MainWindow::setContactVisible(int id, bool visible)
+{
+    auto cell = contactRows.find(id);
+    if(cell == contactRows.end())
+        return;
+    if(visible)
+        ui->tableWidget->showRow(cell->second->row());
+    else
+        ui->tableWidget->hideRow(cell->second->row());
+}
 
 /**
  * Quand l'utilisateur édite l'EditLine de recherche on met à jour la table.
+ * Les contacts sont cherchés dans l'index de Contacts (nom, entreprise, email, téléphone, identifiant et date de
+ * création), qui ignore la casse et les accents (« elodie » trouve « Élodie »). Les cellules de la table ne sont pas
+ * lues : seules les lignes dont la visibilité change (différence entre l'ancien et le nouveau résultat) sont
+ * retrouvées, par leur identifiant.
  * @param text Texte entré par l'utilisateur
  */
 void MainWindow::on_lineEdit_textEdited(const QString &text)
 {
-    std::vector<int> hide{};
-    for(int row=0; row<ui->tableWidget->rowCount(); row++)
-    {
-        bool keep = false;
-        for(int column=0; column<ui->tableWidget->columnCount()-1; column++)
-        {
-            if(ui->tableWidget->item(row, column)->text().contains(text, Qt::CaseInsensitive))
-                keep = true;
-        }
+    std::vector<int> found = dbInterface.getContacts().search(text.toStdString());
 
-        if(keep)
-            ui->tableWidget->showRow(row);
-        else
-            ui->tableWidget->hideRow(row);
-    }
+    std::vector<int> changed;
+    std::set_difference(visibleContacts.begin(), visibleContacts.end(), found.begin(), found.end(),
+                        std::back_inserter(changed));
+    for(int id : changed)
+        setContactVisible(id, false);
+
+    changed.clear();
+    std::set_difference(found.begin(), found.end(), visibleContacts.begin(), visibleContacts.end(),
+                        std::back_inserter(changed));
+    for(int id : changed)
+        setContactVisible(id, true);
+
+    visibleContacts.swap(found);
 }
 
 /**
@@ -103,7 +143,7 @@ void MainWindow::on_actionAddContact_triggered()
 
 /**
  * Quand le dialogue EditContactDialog confirme l'ajout d'un contact.
- * On le récupère et on l'ajoute au cache actuel et à la base de données.
+ * On le récupère et on l'ajoute à la base de données (et donc au cache).
  * On analyse également sa note afin de créer les tâches et on prend en charge son image à l'aide de la méthode imgProcess.
  */
 void MainWindow::addConfirm()
@@ -116,25 +156,22 @@ void MainWindow::addConfirm()
     std::string description = "Création du contact: " + c.getFullName();
     i.setDescription(description);
     i.setId(dbInterface.add(i));
-    c.addInteraction(i);
-    interactions.addInteraction(i);
     imgProcess(editModal->getPicturePath(), c.getId());
-    for(auto& t : editModal->getTodos()) {
+    for(Todo t : editModal->getTodos()) {
         t.setOwnerId(c.getId());
         t.setId(dbInterface.add(t));
     }
 
-    dbInterface.flush();
-    contacts.addContact(c);
     refresh();
 }
 
 /**
- * Quand on quitte sur le bouton "Quitter" : on ferme l'application sans erreur (code: 0)
+ * Quand on quitte sur le bouton "Quitter" : on ferme la fenêtre principale, ce qui termine l'application sans erreur
+ * (code: 0) une fois les écritures en attente terminées (destruction de l'interface de base de données)
  */
 void MainWindow::on_actionClose_triggered()
 {
-    exit(0);
+    close();
 }
 
 /**
@@ -144,7 +181,8 @@ void MainWindow::on_actionClose_triggered()
  * @param id Identifiant du contact à éditer
  */
 void MainWindow::editContact(int id) {
-    editModal = new EditContactDialog(contacts.getContact(id), this);
+    dbInterface.loadHistory(id); // Its todos are replaced on confirmation
+    editModal = new EditContactDialog(dbInterface.getContacts().getContact(id), this);
     connect(editModal, SIGNAL(accepted()), this, SLOT(editConfirm()));
     editModal->exec();
 }
@@ -163,30 +201,26 @@ void MainWindow::editConfirm() {
     i.setDescription(description);
     i.setType(EDIT_CONTACT);
     i.setId(dbInterface.add(i));
-    c.addInteraction(i);
-    interactions.addInteraction(i);
 
     imgProcess(editModal->getPicturePath(), c.getId());
 
-    // Delete old todo
-    for(Todo t: c.getTodos()) {
+    // Delete old todo (copied first: removed todos leave the cache immediately)
+    std::vector<Todo> old;
+    for(const Todo& t: c.getTodos())
+        old.push_back(t);
+    for(Todo& t: old) {
         dbInterface.remove(t);
     }
 
     Todos ts = Todos::extractFromString(c.getNote()); // Get new todos
 
-    // Add this todos to DB
-    for(Todo& t: ts) {
+    // Add this todos to DB (and to the contact's history)
+    for(Todo t: ts) {
         t.setOwnerId(c.getId());
         t.setId(dbInterface.add(t));
     }
 
-    // Set list to Contact
-    c.setTodos(ts);
-
-    dbInterface.update(c); // Update on db
-    *contacts.getContact(c.getId()) = c; // Update application cache
-    dbInterface.flush(); // Push modifications
+    dbInterface.update(c); // Update in cache, written on the next flush (see flushPending)
     refresh(); // Refresh ui
 }
 
@@ -195,20 +229,19 @@ void MainWindow::editConfirm() {
  * @param id Identifiant du contact à supprimer
  */
 void MainWindow::deleteContact(int id) {
-    Contact* c = contacts.getContact(id);
-    if(!c)
+    const Contact* found = dbInterface.getContacts().getContact(id);
+    if(!found)
         return;
+    Contact c = *found; // Removed from cache by remove()
     QMessageBox::StandardButton reply;
     reply = QMessageBox::question(this,
                                   "Confirmation",
-                                  QString::fromStdString("Voulez-vous supprimer le contact: " + c->getFullName() + " ?"),
+                                  QString::fromStdString("Voulez-vous supprimer le contact: " + c.getFullName() + " ?"),
                                   QMessageBox::Yes|QMessageBox::No);
 
     if (reply == QMessageBox::Yes) {
-        this->dbInterface.remove(*c);
-        std::string description = "Suppresion du contact: " + c->getFullName();
-        contacts.remove(id);
-        refresh();
+        this->dbInterface.remove(c);
+        std::string description = "Suppresion du contact: " + c.getFullName();
         Interaction i;
         i.setOwnerId(-1); // Non relié à un contact
         Date d;
@@ -216,9 +249,8 @@ void MainWindow::deleteContact(int id) {
         i.setType(REMOVE_CONTACT);
         i.setDescription(description);
         i.setId(dbInterface.add(i));
-        interactions.addInteraction(i);
         imgDeleteProcess(id);
-        dbInterface.flush();
+        refresh();
     }
 }
 
@@ -227,7 +259,8 @@ void MainWindow::deleteContact(int id) {
  * @param id Identifiant du contact
  */
 void MainWindow::historyContact(int id) {
-    Contact* c = contacts.getContact(id);
+    dbInterface.loadHistory(id);
+    const Contact* c = dbInterface.getContacts().getContact(id);
     if(!c)
         return;
     historyModal = new HistoryDialog(*c, this);
@@ -239,6 +272,8 @@ void MainWindow::historyContact(int id) {
  * Quand l'utilisateur demande l'exportation des données.
  * Procédure:
  *      * On demande un dossier d'exportation afin de créer le export.json;
+ *      * On attend que toutes les tâches et les interactions soient en cache (lues une seule fois, en parallèle par
+ *        deux threads de lecture : l'interface reste disponible);
  *      * On ajoute au gestionnaire JsonManager l'ensemble des données sous forme de map;
  *      * On écrit toutes les données au format JSON dans le bon fichier.
  */
@@ -249,21 +284,24 @@ void MainWindow::on_actionExport_triggered()
     if(path == "")
         return;
 
-    for(auto& c: contacts) {
-        jsonMgr.add(c.toMap());
-        for(auto& t: c.getTodos())
-            jsonMgr.add(t.toMap());
-    }
+    // Not only the histories in cache: the file is written once every table is in cache
+    dbInterface.whenResident([this, path]() {
+        for(const auto& c: dbInterface.getContacts()) {
+            jsonMgr.add(c.toMap());
+            for(const auto& t: dbInterface.getTodos().getTodosOf(c.getId()))
+                jsonMgr.add(t.toMap());
+        }
 
-    for(auto& i : interactions)
-        jsonMgr.add(i.toMap());
+        for(const auto& i : dbInterface.getInteractions())
+            jsonMgr.add(i.toMap());
 
-    QMessageBox msgBox;
-    if(jsonMgr.write(path + "/export.json"))
-        msgBox.setText("Le fichier a bien été édité.");
-    else
-        msgBox.setText("Error d'exporation.");
-    msgBox.exec();
+        QMessageBox msgBox;
+        if(jsonMgr.write(path + "/export.json"))
+            msgBox.setText("Le fichier a bien été édité.");
+        else
+            msgBox.setText("Error d'exporation.");
+        msgBox.exec();
+    });
 }
 
 /**
@@ -271,7 +309,7 @@ void MainWindow::on_actionExport_triggered()
  * Procédure:
  *      * On demande le fichier json a charger;
  *      * le JsonManager charge l'ensemble des données;
- *      * On ajoute toutes les données à la base de données et on recharge le cache de l'application.
+ *      * On ajoute toutes les données à la base de données (et au cache) et seuls les nouveaux contacts sont ajoutés à la table.
  */
 void MainWindow::on_actionImportation_triggered()
 {
@@ -286,72 +324,116 @@ void MainWindow::on_actionImportation_triggered()
         return;
     }
 
-    importFromJsonMgr();
-
-   // Recharchement des données:
-    dbInterface.loadData();
-    contacts = dbInterface.getContacts();
-    interactions = dbInterface.getInteractions();
-    refresh();
+    // The cache is updated by add(): only the new contacts are added to the table, nothing is reloaded
+    const std::vector<int> imported = importFromJsonMgr();
+    const bool sorting = ui->tableWidget->isSortingEnabled();
+    ui->tableWidget->setSortingEnabled(false); // Rows would move while being filled
+    for(int id: imported)
+    {
+        appendContactRow(*dbInterface.getContacts().getContact(id));
+        visibleContacts.push_back(id);
+    }
+    std::sort(visibleContacts.begin(), visibleContacts.end());
+    ui->tableWidget->setSortingEnabled(sorting);
+    if(!ui->lineEdit->text().isEmpty())
+        on_lineEdit_textEdited(ui->lineEdit->text()); // Keep the current search
 }
 
 /**
- * Importe les données du cache du JsonManager et les inclus dans l'application
+ * Importe les données du cache du JsonManager et les inclus dans l'application.
+ * Les contacts reçoivent un nouvel identifiant, leurs interactions et leurs tâches sont rattachées à ce nouvel
+ * identifiant. Les entités sont ajoutées au cache par DBInterface::add : rien n'est rechargé.
+ * @return Identifiants des contacts créés, dans l'ordre du document
  */
-void MainWindow:: importFromJsonMgr()
+std::vector<int> MainWindow::importFromJsonMgr()
 {
-   Contacts cs = Contacts::fromListOfMaps(jsonMgr.getDataWithType("contact"));
-   Interactions is = Interactions::fromListOfMaps(jsonMgr.getDataWithType("interaction"));
-   Todos ts = Todos::fromListOfMaps(jsonMgr.getDataWithType("todo"));
-
-   // Make new id for all contact
-   for(auto& c: cs)
-   {
+    Contacts cs = Contacts::fromListOfMaps(jsonMgr.getDataWithType("contact"));
+    Interactions is = Interactions::fromListOfMaps(jsonMgr.getDataWithType("interaction"));
+    Todos ts = Todos::fromListOfMaps(jsonMgr.getDataWithType("todo"));
+
+    // Make new id for all contact
+    std::vector<int> imported;
+    imported.reserve(cs.size());
+    std::unordered_map<int, int> newIds; // Old id -> new id
+    for(Contact c: cs)
+    {
         int oldId = c.getId();
         c.setId(dbInterface.add(c));
+        newIds[oldId] = c.getId();
+        imported.push_back(c.getId());
+    }
 
-        // Put all interactions
-        for(auto& i: is)
+    // Put all interactions (and register interactions without owner)
+    for(Interaction i: is)
+    {
+        auto owner = newIds.find(i.getOwnerId());
+        if(owner != newIds.end())
         {
-            if(i.getOwnerId() == oldId)
-            {
-                i.setOwnerId(c.getId());
-                dbInterface.add(i);
-            }
+            i.setOwnerId(owner->second);
+            dbInterface.add(i);
         }
+        else if(i.getOwnerId() == -1)
+            dbInterface.add(i);
+    }
 
-        // Put all Todos
-        for(auto& t: ts)
+    // Put all Todos
+    for(Todo t: ts)
+    {
+        auto owner = newIds.find(t.getOwnerId());
+        if(owner != newIds.end())
         {
-            if(t.getOwnerId() == oldId)
-            {
-                t.setId(c.getId());
-                dbInterface.add(t);
-            }
+            t.setOwnerId(owner->second);
+            dbInterface.add(t);
         }
-   }
+    }
 
+    return imported;
+}
 
-   // Registrer interactions without owner
-   for(auto& i: interactions)
-   {
-       if(i.getOwnerId() == -1)
-           dbInterface.add(i);
-   }
 
+/**
+ * Écrit dans la base de données les actions de l'utilisateur en attente, en une seule transaction (appelée
+ * régulièrement). Les actions sont déjà dans le journal des opérations : attendre le prochain flush ne fait rien
+ * perdre en cas d'arrêt, et les lectures réappliquent celles qui ne sont pas encore écrites.
+ */
+void MainWindow::flushPending()
+{
+    if(dbInterface.hasPendingChanges())
+        dbInterface.flush();
 }
 
+/**
+ * Identifiants des contacts sélectionnés dans la table (chaque contact une seule fois, dans l'ordre croissant).
+ * @return Identifiants des contacts sélectionnés (vide si aucune ligne n'est sélectionnée)
+ */
+std::vector<int> MainWindow::selectedContacts() const
+{
+    std::vector<int> ids;
+    for(const QTableWidgetItem* item : ui->tableWidget->selectedItems())
+        ids.push_back(ui->tableWidget->item(item->row(), 0)->text().toInt());
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+    return ids;
+}
 
 /**
- * Quand l'utilisateur clique sur le bouton pour obtenir l'historique de toutes les interactions.
- * On affiche une fenêtre de dialogue du type HistoryDialog afin d'afficher les informations.
+ * Quand l'utilisateur clique sur le bouton pour obtenir l'historique des interactions.
+ * On affiche une fenêtre de dialogue du type HistoryDialog afin d'afficher les informations : la chronologie des
+ * contacts sélectionnés (leurs historiques fusionnés par date), ou toutes les interactions si aucun ne l'est.
  */
 void MainWindow::on_historyButton_clicked()
 {
-    historyModal = new HistoryDialog(interactions, this);
-    historyModal->exec();
-    delete historyModal;
-
+    // Not only the histories in cache: opened once every table is in cache (read only on the first time)
+    dbInterface.whenResident([this, ids = selectedContacts()]() {
+        if(ids.empty())
+            historyModal = new HistoryDialog(dbInterface.getInteractions(), this);
+        else
+            historyModal = new HistoryDialog(dbInterface.getInteractions().getInteractionsByDate(ids, true),
+                                             "Historique: " + QString::number(static_cast<int>(ids.size())) + " contact(s)",
+                                             this);
+        historyModal->exec();
+        delete historyModal;
+    });
 }
 
 /**
@@ -360,17 +442,16 @@ void MainWindow::on_historyButton_clicked()
  */
 void MainWindow::on_actionStats_triggered()
 {
-    QMessageBox msgBox;
-    int todoCount = 0;
-    for(auto& c: contacts)
-        todoCount += c.getTodos().size();
-    std::string text = "Statistiques:\n";
-    text += "Nombre de contacts: " + std::to_string(contacts.size()) + "\n";
-    text += "Nombre d'interactions: " + std::to_string(interactions.size()) + "\n";
-    text += "Nombre de rendez-vous: " + std::to_string(todoCount) + "\n";
-    msgBox.setText(QString::fromStdString(text));
-    msgBox.exec();
-
+    // Pending operations included: counted once every table is in cache
+    dbInterface.whenResident([this]() {
+        QMessageBox msgBox;
+        std::string text = "Statistiques:\n";
+        text += "Nombre de contacts: " + std::to_string(dbInterface.getContacts().size()) + "\n";
+        text += "Nombre d'interactions: " + std::to_string(dbInterface.getInteractions().size()) + "\n";
+        text += "Nombre de rendez-vous: " + std::to_string(dbInterface.getTodos().size()) + "\n";
+        msgBox.setText(QString::fromStdString(text));
+        msgBox.exec();
+    });
 }
 
 /**
@@ -403,12 +484,18 @@ void MainWindow::imgDeleteProcess(int id)
 
 /**
  * Quand l'utilisateur demande à accéder à la fenêtre de gestions des rendez-vous.
- * Affiche une boite de dialogue du type TodoDialog qui prend en paramètre l'ensemble des contacts afin de gérer les rendez-vous.
+ * Affiche une boite de dialogue du type TodoDialog qui prend en paramètre l'ensemble des contacts afin de gérer les rendez-vous
+ * (seulement ceux des contacts sélectionnés s'il y en a).
  */
 void MainWindow::on_todoButton_clicked()
 {
-    todoModal = new TodoDialog(contacts, this);
-    todoModal->exec();
+    // Not only the histories in cache: opened once every table is in cache (read only on the first time), the dialog
+    // shows the cache itself, kept up to date by add, update and remove
+    dbInterface.whenResident([this, ids = selectedContacts()]() {
+        todoModal = new TodoDialog(dbInterface.getContacts(), dbInterface.getTodos(), this, ids);
+        todoModal->exec();
+        delete todoModal;
+    });
 }
 
 /**
@@ -423,10 +510,13 @@ MainWindow::MainWindow(QWidget *parent)
     setWindowTitle("Menu Principal");
     dbInterface.open();
     dbInterface.loadData();
-    contacts = dbInterface.getContacts();
-    interactions = dbInterface.getInteractions();
     refresh();
     //ui->tableWidget->sortItems(4, Qt::DescendingOrder); // reverse order
+
+    // Group commit: the actions of the last seconds are written together (they are already in the journal)
+    QTimer* flushTimer = new QTimer(this);
+    connect(flushTimer, SIGNAL(timeout()), this, SLOT(flushPending()));
+    flushTimer->start(FLUSH_INTERVAL);
 }
 
 /**
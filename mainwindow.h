@@ -15,6 +15,9 @@
 #include <QPushButton>
 #include <QLayout>
 #include <QMenu>
+#include <QTimer>
+#include <unordered_map>
+#include <vector>
 #include "editcontactdialog.h"
 #include "historydialog.h"
 #include "tododialog.h"
@@ -31,22 +34,23 @@ QT_END_NAMESPACE
 /**
  * Classe ave l'interface principale de l'application.
  * Elle met en relation l'ensemble des autres classes et les gère.
- * C'est également cette classe qui contient le cache actuelle de l'application et qui intéragit avec l'interface de base de données (DBInterface).
+ * Elle intéragit avec l'interface de base de données (DBInterface), qui contient l'unique cache de l'application : la fenêtre et ses dialogues le consultent par référence.
  * @brief Classe ave l'interface principale de l'application
  */
 class MainWindow : public QMainWindow
 {
     Q_OBJECT
 private:
-    DBInterface dbInterface; /*!< Interface de base de données */
-    Contacts contacts; /*!< Liste des contacts */
-    Interactions interactions; /*!< Liste des interactions */
+    DBInterface dbInterface; /*!< Interface de base de données (et cache des données) */
     JsonManager jsonMgr; /*!< Interface pour le Json (exportation) */
+    static constexpr int FLUSH_INTERVAL = 5000; /*!< Délai entre deux écritures groupées des actions (ms) */
 
 public:
     void refresh();
+    void appendContactRow(const Contact& c);
+    void setContactVisible(int id, bool visible);
     void imgProcess(std::string fileName, int id);
-    void importFromJsonMgr();
+    std::vector<int> importFromJsonMgr();
     MainWindow(QWidget *parent = nullptr);
     ~MainWindow();
 
@@ -64,6 +68,7 @@ private slots:
     void editConfirm();
 
     void imgDeleteProcess(int id);
+    void flushPending();
 
     // UI
     void on_actionExport_triggered();
@@ -75,7 +80,11 @@ private slots:
 
     void on_todoButton_clicked();
 private:
+    [[nodiscard]] std::vector<int> selectedContacts() const;
+
     Ui::MainWindow *ui; /*!< Interface de la classe MainWindow */
+    std::unordered_map<int, QTableWidgetItem*> contactRows; /*!< Cellule de l'identifiant de chaque contact de la table (sa ligne suit le tri) */
+    std::vector<int> visibleContacts; /*!< Contacts dont la ligne est affichée (triés, voir on_lineEdit_textEdited) */
     EditContactDialog* editModal; /*!< Fenêtre d'édition/création de contact */
     HistoryDialog* historyModal; /*!< Fenêtre d'historique d'interactions */
     TodoDialog* todoModal; /*!< Fenêtre pour consulter les rendez-vous */
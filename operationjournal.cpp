@@ -0,0 +1,205 @@
+/**
+ * @file operationjournal.cpp
+ *
+ * @brief Définition de la classe OperationJournal (journal des opérations non encore écrites)
+ *
+ * @version 1.0
+ *
+ * @author LEESTMANS Richard
+ * @author COUDERT Nicolas
+ */
+
+#include "operationjournal.h"
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+/**
+ * Écrit sur le disque les données d'un fichier déjà transmises au système
+ * @param handle Descripteur du fichier
+ * @return Si l'écriture a réussi
+ */
+static bool syncToDisk(int handle)
+{
+#ifdef Q_OS_WIN
+    return _commit(handle) == 0;
+#else
+    return fsync(handle) == 0;
+#endif
+}
+
+/**
+ * Ouvre (ou crée) le journal
+ * @param path Chemin du fichier du journal
+ * @return Si le journal est ouvert
+ */
+bool OperationJournal::open(const QString& path)
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->file.setFileName(path);
+    this->discarded = 0;
+    return this->file.open(QIODevice::ReadWrite | QIODevice::Append | QIODevice::Unbuffered);
+}
+
+/**
+ * Ferme le journal (son contenu est gardé)
+ */
+void OperationJournal::close()
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+    if(this->file.isOpen())
+    {
+        syncToDisk(this->file.handle());
+        this->file.close();
+    }
+}
+
+/**
+ * Indique si le journal est ouvert
+ * @return Si le journal est ouvert
+ */
+bool OperationJournal::isOpen() const
+{
+    return this->file.isOpen();
+}
+
+/**
+ * Lit les opérations du journal qui n'ont pas encore été écrites dans la base, dans l'ordre d'ajout.
+ * Une dernière ligne incomplète (arrêt pendant un ajout) ou illisible est ignorée.
+ * @return Opérations à rejouer
+ */
+std::vector<OperationJournal::Record> OperationJournal::read()
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+    std::vector<std::pair<std::int64_t, Record>> records; // With the position of their line
+    std::int64_t written = 0; // Operations before this position are already in the database
+
+    this->file.seek(0);
+    const QByteArray content = this->file.readAll();
+    std::int64_t start = 0;
+    for(std::int64_t newline = content.indexOf('\n'); newline >= 0; newline = content.indexOf('\n', start))
+    {
+        const QJsonDocument line = QJsonDocument::fromJson(content.mid(start, newline - start));
+        const QJsonObject object = line.object();
+        if(object.contains("written"))
+            written = object.value("written").toVariant().toLongLong();
+        else if(line.isObject())
+            records.push_back({ start, { static_cast<unsigned int>(object.value("type").toInt()),
+                                         static_cast<unsigned int>(object.value("subtype").toInt()),
+                                         object.value("values").toObject().toVariantMap() } });
+        start = newline + 1;
+    }
+
+    std::vector<Record> pending;
+    for(auto& [position, record] : records)
+        if(position >= written)
+            pending.push_back(std::move(record));
+    return pending;
+}
+
+/**
+ * Ajoute une opération à la fin du journal. La ligne est transmise au système mais n'est sur le disque qu'après la
+ * prochaine synchronisation (voir requestSync).
+ * @param type Type d'entité (voir DBTodoTypes)
+ * @param subtype Opération (voir DBTodoSubTypes)
+ * @param values Valeurs liées à la requête de l'opération, par nom de paramètre
+ */
+void OperationJournal::append(unsigned int type, unsigned int subtype, const QVariantMap& values)
+{
+    QJsonObject record;
+    record.insert("type", static_cast<int>(type));
+    record.insert("subtype", static_cast<int>(subtype));
+    record.insert("values", QJsonObject::fromVariantMap(values));
+    QByteArray line = QJsonDocument(record).toJson(QJsonDocument::Compact);
+    line.append('\n');
+
+    std::lock_guard<std::mutex> lock(this->mutex);
+    if(this->file.isOpen())
+        this->file.write(line);
+}
+
+/**
+ * Renvoie la position (absolue) de la fin du journal : les opérations déjà ajoutées se trouvent avant
+ * @return Position de la fin du journal
+ */
+std::int64_t OperationJournal::end()
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->discarded + this->file.size();
+}
+
+/**
+ * Demande une synchronisation du journal sur le disque.
+ * @return Vrai si aucune synchronisation n'était déjà demandée : l'appelant doit alors planifier sync(), sinon la
+ * synchronisation déjà planifiée couvrira aussi les derniers ajouts
+ */
+bool OperationJournal::requestSync()
+{
+    return !this->syncRequested.exchange(true);
+}
+
+/**
+ * Écrit sur le disque (fsync) toutes les opérations ajoutées jusqu'ici. Le fichier n'est pas verrouillé : les ajouts
+ * faits pendant l'écriture demandent une nouvelle synchronisation.
+ * @return Si l'écriture a réussi
+ */
+bool OperationJournal::sync()
+{
+    this->syncRequested = false;
+    return this->file.isOpen() && syncToDisk(this->file.handle());
+}
+
+/**
+ * Retire du journal les opérations écrites dans la base de données.
+ * Si aucune opération n'a été ajoutée depuis, le journal est vidé. Sinon, la position est ajoutée au journal (les
+ * opérations qui la précèdent ne seront pas rejouées) : le fichier n'est jamais réécrit.
+ * @param upTo Position (absolue, voir end) jusqu'à laquelle les opérations ont été écrites
+ */
+void OperationJournal::discard(std::int64_t upTo)
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+    const std::int64_t size = this->file.size();
+    const std::int64_t written = upTo - this->discarded; // Position in the file
+    if(!this->file.isOpen() || written <= 0)
+        return;
+
+    if(written >= size)
+    {
+        this->file.resize(0);
+        this->discarded += size;
+        return;
+    }
+
+    QJsonObject marker;
+    marker.insert("written", static_cast<qint64>(written));
+    QByteArray line = QJsonDocument(marker).toJson(QJsonDocument::Compact);
+    line.append('\n');
+    this->file.write(line);
+}
+
+/**
+ * Vide le journal (toutes ses opérations ont été écrites dans la base de données)
+ */
+void OperationJournal::clear()
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+    if(!this->file.isOpen())
+        return;
+
+    this->discarded += this->file.size();
+    this->file.resize(0);
+    syncToDisk(this->file.handle());
+}
+
+/**
+ * Destructeur : le journal est écrit sur le disque et fermé
+ */
+OperationJournal::~OperationJournal()
+{
+    close();
+}
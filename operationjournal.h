@@ -0,0 +1,71 @@
+/**
+ * @file operationjournal.h
+ *
+ * @brief Déclaration de la classe OperationJournal (journal des opérations non encore écrites)
+ *
+ * @author LEESTMANS Richard
+ * @author COUDERT Nicolas
+ */
+
+#ifndef CDAA_OPERATIONJOURNAL_H
+#define CDAA_OPERATIONJOURNAL_H
+
+#include <QFile>
+#include <QString>
+#include <QVariant>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+/**
+ * Journal des opérations (ajouts, modifications, suppressions) de DBInterface, tenu à côté de la base de données
+ * (fichier "<base>.oplog"). Chaque opération y est ajoutée, une ligne JSON par opération, avant d'être mise en attente :
+ * si l'application s'arrête avant le flush, les opérations sont rejouées au démarrage suivant.
+ * Les écritures sur le disque (fsync) sont groupées : toutes les opérations ajoutées avant une synchronisation
+ * partagent le même fsync, exécuté par le thread d'écriture (voir requestSync et sync).
+ * Une fois un flush écrit dans la base, les opérations qu'il contient sont retirées du journal (voir discard). Les
+ * positions utilisées sont absolues (depuis l'ouverture du journal) : elles restent valides après un retrait.
+ * \brief Journal des opérations non encore écrites
+ */
+class OperationJournal
+{
+public:
+    /**
+     * Opération lue dans le journal
+     */
+    struct Record
+    {
+        unsigned int type; /*!< Type d'entité (voir DBTodoTypes) */
+        unsigned int subtype; /*!< Opération (voir DBTodoSubTypes) */
+        QVariantMap values; /*!< Valeurs liées à la requête de l'opération, par nom de paramètre */
+    };
+
+private:
+    QFile file; /*!< Fichier du journal (ouvert sans tampon : chaque ajout est transmis au système) */
+    std::mutex mutex; /*!< Protège le fichier et discarded (ajouts, retraits) */
+    std::int64_t discarded = 0; /*!< Octets retirés du début du fichier depuis l'ouverture */
+    std::atomic<bool> syncRequested{false}; /*!< Une synchronisation est déjà demandée */
+
+public:
+    // Voir operationjournal.cpp pour la documentation des méthodes
+    bool open(const QString& path);
+    void close();
+    [[nodiscard]] bool isOpen() const;
+
+    [[nodiscard]] std::vector<Record> read();
+    void append(unsigned int type, unsigned int subtype, const QVariantMap& values);
+    [[nodiscard]] std::int64_t end();
+
+    [[nodiscard]] bool requestSync();
+    bool sync();
+    void discard(std::int64_t upTo);
+    void clear();
+
+    OperationJournal() = default;
+    OperationJournal(const OperationJournal&) = delete;
+    OperationJournal& operator=(const OperationJournal&) = delete;
+    ~OperationJournal();
+};
+
+#endif // CDAA_OPERATIONJOURNAL_H
@@ -0,0 +1,209 @@
+/**
+ * @file storageprofile.cpp
+ *
+ * @brief Définition de la classe StorageProfile (réglages de stockage SQLite)
+ *
+ * @version 1.0
+ *
+ * @author LEESTMANS Richard
+ * @author COUDERT Nicolas
+ */
+
+#include "storageprofile.h"
+#include <QDebug>
+#include <QFileInfo>
+#include <QSettings>
+
+/**
+ * Renvoie le nom du profil
+ * @return Nom du profil
+ */
+const QString& StorageProfile::getName() const
+{
+    return this->name;
+}
+
+/**
+ * Renvoie le mode du journal
+ * @return Valeur de PRAGMA journal_mode
+ */
+const QString& StorageProfile::getJournalMode() const
+{
+    return this->journalMode;
+}
+
+/**
+ * Renvoie le niveau de synchronisation
+ * @return Valeur de PRAGMA synchronous
+ */
+const QString& StorageProfile::getSynchronous() const
+{
+    return this->synchronous;
+}
+
+/**
+ * Renvoie la taille du cache
+ * @return Valeur de PRAGMA cache_size (en pages si positif, en Kio si négatif)
+ */
+int StorageProfile::getCacheSize() const
+{
+    return this->cacheSize;
+}
+
+/**
+ * Renvoie la taille de la projection mémoire
+ * @return Valeur de PRAGMA mmap_size, en octets
+ */
+std::int64_t StorageProfile::getMmapSize() const
+{
+    return this->mmapSize;
+}
+
+/**
+ * Renvoie le stockage des tables temporaires
+ * @return Valeur de PRAGMA temp_store
+ */
+const QString& StorageProfile::getTempStore() const
+{
+    return this->tempStore;
+}
+
+/**
+ * Renvoie la taille des pages
+ * @return Valeur de PRAGMA page_size, en octets
+ */
+int StorageProfile::getPageSize() const
+{
+    return this->pageSize;
+}
+
+/**
+ * Renvoie les PRAGMA à exécuter sur la première connexion ouverte, dans l'ordre : la taille des pages (qui n'a
+ * d'effet que sur une base de données vide, avant le passage en WAL), le mode du journal (enregistré dans le fichier)
+ * puis les réglages propres à chaque connexion (voir getConnectionPragmas).
+ * @return Requêtes PRAGMA
+ */
+QStringList StorageProfile::getPragmas() const
+{
+    QStringList pragmas;
+    pragmas << "PRAGMA page_size = " + QString::number(this->pageSize);
+    pragmas << "PRAGMA journal_mode = " + this->journalMode;
+    for(const QString& pragma : getConnectionPragmas())
+        pragmas << pragma;
+    return pragmas;
+}
+
+/**
+ * Renvoie les PRAGMA propres à une connexion, à exécuter sur chaque connexion ouverte (par exemple celle du thread
+ * d'écriture)
+ * @return Requêtes PRAGMA
+ */
+QStringList StorageProfile::getConnectionPragmas() const
+{
+    QStringList pragmas;
+    pragmas << "PRAGMA synchronous = " + this->synchronous;
+    pragmas << "PRAGMA cache_size = " + QString::number(this->cacheSize);
+    pragmas << "PRAGMA mmap_size = " + QString::number(static_cast<long long>(this->mmapSize));
+    pragmas << "PRAGMA temp_store = " + this->tempStore;
+    return pragmas;
+}
+
+/**
+ * Indique si un profil porte ce nom
+ * @param name Nom du profil
+ * @return Si le profil existe
+ */
+bool StorageProfile::exists(const QString& name)
+{
+    return name == "safe" || name == "balanced" || name == "fast";
+}
+
+/**
+ * Renvoie un profil nommé ("safe", "balanced" ou "fast", voir la description de la classe)
+ * @param name Nom du profil
+ * @return Profil (le profil par défaut si le nom est inconnu)
+ */
+StorageProfile StorageProfile::named(const QString& name)
+{
+    StorageProfile profile;
+    if(name == "balanced")
+    {
+        profile.name = name;
+        profile.journalMode = "WAL";
+        profile.synchronous = "NORMAL";
+        profile.cacheSize = -16 * 1024; // 16 MiB
+        profile.mmapSize = 64 * 1024 * 1024;
+        profile.tempStore = "MEMORY";
+    }
+    else if(name == "fast")
+    {
+        profile.name = name;
+        profile.journalMode = "WAL";
+        profile.synchronous = "OFF";
+        profile.cacheSize = -64 * 1024; // 64 MiB
+        profile.mmapSize = 256 * 1024 * 1024;
+        profile.tempStore = "MEMORY";
+    }
+    else if(name != DEFAULT_NAME)
+        qDebug() << "Profil de stockage inconnu :" << name << "(profil par défaut utilisé)";
+    return profile;
+}
+
+/**
+ * Renvoie la valeur d'une clé du fichier de configuration si elle fait partie des valeurs acceptées
+ * @param settings Fichier de configuration
+ * @param key Clé
+ * @param accepted Valeurs acceptées (en majuscules)
+ * @param value Valeur du profil, remplacée par celle du fichier si elle est acceptée
+ */
+static void readChoice(const QSettings& settings, const QString& key, const QStringList& accepted, QString& value)
+{
+    if(!settings.contains(key))
+        return;
+
+    const QString read = settings.value(key).toString().toUpper();
+    if(accepted.contains(read))
+        value = read;
+    else
+        qDebug() << "Valeur ignorée pour" << key << ":" << read;
+}
+
+/**
+ * Lit un profil dans un fichier de configuration (format INI). La clé "profile" choisit le profil nommé de départ
+ * (voir named), les clés journal_mode, synchronous, cache_size, mmap_size, temp_store et page_size en remplacent les
+ * réglages. Exemple :
+ * @code
+ * profile=balanced
+ * cache_size=-32768
+ * @endcode
+ * @param path Chemin du fichier de configuration
+ * @return Profil lu (le profil par défaut si le fichier n'existe pas)
+ */
+StorageProfile StorageProfile::fromFile(const QString& path)
+{
+    if(!QFileInfo::exists(path))
+        return StorageProfile();
+
+    const QSettings settings(path, QSettings::IniFormat);
+    StorageProfile profile = named(settings.value("profile", DEFAULT_NAME).toString());
+    readChoice(settings, "journal_mode", QStringList() << "DELETE" << "TRUNCATE" << "PERSIST" << "MEMORY" << "WAL"
+               << "OFF", profile.journalMode);
+    readChoice(settings, "synchronous", QStringList() << "OFF" << "NORMAL" << "FULL" << "EXTRA", profile.synchronous);
+    readChoice(settings, "temp_store", QStringList() << "DEFAULT" << "FILE" << "MEMORY", profile.tempStore);
+    if(settings.contains("cache_size"))
+        profile.cacheSize = settings.value("cache_size").toInt();
+    if(settings.contains("mmap_size"))
+        profile.mmapSize = settings.value("mmap_size").toLongLong();
+    if(settings.contains("page_size"))
+        profile.pageSize = settings.value("page_size").toInt();
+    return profile;
+}
+
+/**
+ * Constructeur du profil par défaut ("safe" : réglages par défaut de SQLite). Son journal DELETE fait attendre le
+ * thread d'écriture pendant les lectures de ConnectionPool : "balanced" ou "fast" pour des lectures parallèles.
+ */
+StorageProfile::StorageProfile() : name(DEFAULT_NAME), journalMode("DELETE"), synchronous("FULL"),
+    cacheSize(-2000), mmapSize(0), tempStore("DEFAULT"), pageSize(4096) // SQLite defaults (2 MiB cache)
+{
+}
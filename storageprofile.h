@@ -0,0 +1,65 @@
+/**
+ * @file storageprofile.h
+ *
+ * @brief Déclaration de la classe StorageProfile (réglages de stockage SQLite)
+ *
+ * @author LEESTMANS Richard
+ * @author COUDERT Nicolas
+ */
+
+#ifndef CDAA_STORAGEPROFILE_H
+#define CDAA_STORAGEPROFILE_H
+
+#include <QString>
+#include <QStringList>
+#include <cstdint>
+
+/**
+ * Réglages de stockage appliqués par DBInterface à l'ouverture de la base de données (PRAGMA SQLite) : mode du
+ * journal, niveau de synchronisation, taille du cache, taille de la projection mémoire (mmap), stockage des tables
+ * temporaires et taille des pages.
+ * Trois profils sont nommés :
+ * - "safe" (par défaut) : journal classique (DELETE) et synchronisation complète, réglages par défaut de SQLite
+ *   (le comportement sans profil) ;
+ * - "balanced" : journal WAL (les lectures ne bloquent pas le thread d'écriture), synchronisation
+ *   NORMAL (rien n'est perdu si l'application s'arrête, seule une coupure de courant peut annuler les dernières
+ *   transactions), cache de 16 Mio et projection mémoire de 64 Mio ;
+ * - "fast" : journal WAL sans synchronisation, grand cache et grande projection mémoire (pour les imports).
+ * Le journal WAL n'est utilisé que s'il est choisi : profil "balanced" ou "fast", ou clé journal_mode d'un fichier de
+ * configuration (voir fromFile).
+ * \brief Réglages de stockage SQLite
+ */
+class StorageProfile
+{
+private:
+    QString name; /*!< Nom du profil */
+    QString journalMode; /*!< PRAGMA journal_mode (DELETE, TRUNCATE, PERSIST, MEMORY, WAL, OFF) */
+    QString synchronous; /*!< PRAGMA synchronous (OFF, NORMAL, FULL, EXTRA) */
+    int cacheSize; /*!< PRAGMA cache_size (en pages si positif, en Kio si négatif) */
+    std::int64_t mmapSize; /*!< PRAGMA mmap_size, en octets (0: désactivé) */
+    QString tempStore; /*!< PRAGMA temp_store (DEFAULT, FILE, MEMORY) */
+    int pageSize; /*!< PRAGMA page_size, en octets (seulement pour une base de données vide) */
+
+public:
+    static constexpr const char* DEFAULT_NAME = "safe"; /*!< Nom du profil par défaut */
+
+    // Voir storageprofile.cpp pour la documentation des méthodes
+    [[nodiscard]] const QString& getName() const;
+    [[nodiscard]] const QString& getJournalMode() const;
+    [[nodiscard]] const QString& getSynchronous() const;
+    [[nodiscard]] int getCacheSize() const;
+    [[nodiscard]] std::int64_t getMmapSize() const;
+    [[nodiscard]] const QString& getTempStore() const;
+    [[nodiscard]] int getPageSize() const;
+
+    [[nodiscard]] QStringList getPragmas() const;
+    [[nodiscard]] QStringList getConnectionPragmas() const;
+
+    [[nodiscard]] static bool exists(const QString& name);
+    [[nodiscard]] static StorageProfile named(const QString& name);
+    [[nodiscard]] static StorageProfile fromFile(const QString& path);
+
+    StorageProfile();
+};
+
+#endif // CDAA_STORAGEPROFILE_H
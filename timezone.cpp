@@ -0,0 +1,159 @@
+/**
+ * @file timezone.cpp
+ *
+ * @brief Définition de la classe TimeZone (conversion heure UTC / heure locale)
+ *
+ * @version 1.0
+ *
+ * @author LEESTMANS Richard
+ * @author COUDERT Nicolas
+ */
+
+#include "timezone.h"
+#include "date.h"
+#include <algorithm>
+#include <limits>
+
+/**
+ * Table des changements de décalage horaire, construite au premier appel.
+ * L'initialisation d'une variable statique locale est garantie sans concurrence par le C++11.
+ * @return Changements de décalage triés par date
+ */
+const std::vector<TimeZone::Transition>& TimeZone::transitions()
+{
+    static const std::vector<Transition> table = buildTransitions();
+    return table;
+}
+
+/**
+ * Construit la table des changements de décalage entre 1900 et 2100.
+ * Le décalage est relevé chaque jour, chaque changement est ensuite localisé à la seconde par dichotomie. Le relevé
+ * reprend à partir du changement trouvé : deux changements rapprochés (heure d'été annulée dans la semaine, par
+ * exemple) sont tous les deux enregistrés.
+ * En dehors de cet intervalle (ou avant 1970 sur les systèmes qui ne le gèrent pas), le décalage de la borne la plus
+ * proche est utilisé.
+ * @return Changements de décalage triés par date
+ */
+std::vector<TimeZone::Transition> TimeZone::buildTransitions()
+{
+#ifdef _WIN32
+    _tzset();
+#else
+    tzset();
+#endif
+
+    const time_t step = 86400;
+    const time_t first = static_cast<time_t>(Date::fromCivil(1900, 1, 1).getEpoch());
+    const time_t last = static_cast<time_t>(Date::fromCivil(2100, 1, 1).getEpoch());
+
+    // Find the first instant the system can convert
+    time_t previous = first;
+    std::int64_t offset = 0;
+    while(previous < 0 && !offsetOf(previous, offset))
+        previous += step;
+    if(previous >= 0)
+    {
+        previous = 0;
+        offsetOf(previous, offset);
+    }
+
+    std::vector<Transition> table;
+    table.push_back({std::numeric_limits<time_t>::min(), offset});
+
+    // The offset at low is always the last one of the table
+    time_t low = previous;
+    while(low < last)
+    {
+        time_t high = std::min(low + step, last);
+        if(!offsetOf(high, offset) || offset == table.back().offset)
+        {
+            low = high;
+            continue;
+        }
+
+        // Change between low and high: find the exact second
+        while(high - low > 1)
+        {
+            time_t middle = low + (high - low) / 2;
+            std::int64_t middleOffset;
+            if(offsetOf(middle, middleOffset) && middleOffset != table.back().offset)
+                high = middle;
+            else
+                low = middle;
+        }
+        offsetOf(high, offset);
+        table.push_back({high, offset});
+        low = high; // Another change may follow within the same day
+    }
+
+    return table;
+}
+
+/**
+ * Version réentrante de localtime (localtime_r ou localtime_s selon le système).
+ * @param utc Instant UTC
+ * @param out Structure tm à compléter
+ * @return Si la conversion a réussi
+ */
+bool TimeZone::localTime(time_t utc, struct tm& out)
+{
+#ifdef _WIN32
+    return localtime_s(&out, &utc) == 0;
+#else
+    return localtime_r(&utc, &out) != nullptr;
+#endif
+}
+
+/**
+ * Calcule le décalage à un instant donné en interrogeant le système (utilisé pour construire la table).
+ * @param utc Instant UTC
+ * @param offset Décalage de l'heure locale en secondes
+ * @return Si le système a pu convertir cet instant
+ */
+bool TimeZone::offsetOf(time_t utc, std::int64_t& offset)
+{
+    struct tm tm{};
+    if(!localTime(utc, tm))
+        return false;
+
+    std::int64_t local = Date::fromCivil(tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday).getEpoch()
+            + tm.tm_hour * 3600 + tm.tm_min * 60 + tm.tm_sec;
+    offset = local - static_cast<std::int64_t>(utc);
+    return true;
+}
+
+/**
+ * Renvoie le décalage de l'heure locale par rapport à UTC à un instant donné.
+ * @param utc Instant UTC
+ * @return Décalage en secondes (Exemple: 7200 en heure d'été à Paris)
+ */
+std::int64_t TimeZone::offsetAt(time_t utc)
+{
+    const std::vector<Transition>& table = transitions();
+    auto next = std::upper_bound(table.begin(), table.end(), utc,
+                                 [](time_t t, const Transition& tr) { return t < tr.utc; });
+    return std::prev(next)->offset;
+}
+
+/**
+ * Convertit un instant UTC en heure locale.
+ * @param utc Nombre de secondes depuis le 01/01/1970 (UTC)
+ * @return Nombre de secondes (heure locale) depuis le 01/01/1970 00:00
+ */
+std::int64_t TimeZone::toLocal(time_t utc)
+{
+    return static_cast<std::int64_t>(utc) + offsetAt(utc);
+}
+
+/**
+ * Convertit une heure locale en instant UTC.
+ * Pour une heure locale ambiguë (passage à l'heure d'hiver) ou inexistante (passage à l'heure d'été), le décalage
+ * en vigueur juste avant le changement est utilisé.
+ * @param local Nombre de secondes (heure locale) depuis le 01/01/1970 00:00
+ * @return Nombre de secondes depuis le 01/01/1970 (UTC)
+ */
+time_t TimeZone::toUtc(std::int64_t local)
+{
+    time_t guess = static_cast<time_t>(local - offsetAt(static_cast<time_t>(local)));
+    return static_cast<time_t>(local - offsetAt(guess));
+}
@@ -0,0 +1,47 @@
+/**
+ * @file timezone.h
+ *
+ * @brief Déclaration de la classe TimeZone (conversion heure UTC / heure locale)
+ *
+ * @author LEESTMANS Richard
+ * @author COUDERT Nicolas
+ */
+
+#ifndef CDAA_TIMEZONE_H
+#define CDAA_TIMEZONE_H
+
+#include <ctime>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Conversion entre le temps UTC (time_t) et l'heure locale de la machine.
+ * Le décalage horaire et ses changements (heure d'été/hiver) sont lus une seule fois, au premier appel, avec la
+ * version réentrante de localtime. Les conversions suivantes ne font qu'une recherche dans cette table en lecture
+ * seule : elles peuvent être appelées depuis n'importe quel thread.
+ * @brief Conversion UTC / heure locale réentrante
+ */
+class TimeZone
+{
+private:
+    /**
+     * Changement de décalage horaire
+     */
+    struct Transition {
+        time_t utc; /*!< Instant (UTC) à partir duquel le décalage s'applique */
+        std::int64_t offset; /*!< Décalage de l'heure locale par rapport à UTC, en secondes */
+    };
+
+    static const std::vector<Transition>& transitions();
+    static std::vector<Transition> buildTransitions();
+    static bool localTime(time_t utc, struct tm& out);
+    static bool offsetOf(time_t utc, std::int64_t& offset);
+
+public:
+    // Voir timezone.cpp pour la documentation des méthodes
+    [[nodiscard]] static std::int64_t offsetAt(time_t utc);
+    [[nodiscard]] static std::int64_t toLocal(time_t utc);
+    [[nodiscard]] static time_t toUtc(std::int64_t local);
+};
+
+#endif // CDAA_TIMEZONE_H
@@ -65,6 +65,14 @@ std::string &Todo::getDescription() {
     return this->description;
 }
 
+/**
+ * Renvoie la description de la tâche (version constante)
+ * @return Description de la tâche
+ */
+const std::string &Todo::getDescription() const {
+    return this->description;
+}
+
 /**
  * Définit la date à laquelle la tâche doit être réalisée.
  * S'il n'y a pas de date, spécifié une date au 1er janvier 1970 (0 seconde)
@@ -83,41 +91,31 @@ Date& Todo::getDate() {
 }
 
 /**
- * Renvoie si oui ou non la tâche est urgente
+ * Renvoie la date à laquelle la tâche doit être réalisée (version constante).
+ * @return Date à laquelle la tâche doit être réalisée.
+ */
+const Date& Todo::getDate() const {
+    return this->date;
+}
+
+/**
+ * Renvoie si oui ou non la tâche est urgente (sans date)
  * @return Urgente ou non
  */
-bool Todo::isUrgent()
+bool Todo::isUrgent() const
 {
-    return getDate().getTotalSeconds() == -1;
+    return this->urgent;
 }
 
-
-std::string Todo::getQuery(int mode)
+/**
+ * Définit si la tâche est urgente (sans date)
+ * @param urgent Urgente ou non
+ */
+void Todo::setUrgent(bool urgent)
 {
-    if(mode == DELETE)
-        return "DELETE FROM todo WHERE id=" + std::to_string(this->id);
-
-    // Secure to prevent SQL Injections
-    Utils::addSlashes(this->description);
-
-    switch(mode)
-    {
-        case UPDATE:
-            return "UPDATE todo SET "
-                    "description='" + description + "', "
-                    "date='" + date.getSqlFormat()+"' "
-                    "WHERE id="+std::to_string(id);
-        case CREATE:
-            return "INSERT INTO todo "
-                   "(owner_id, description, date) "
-                   "VALUES "
-                   "(" + std::to_string(ownerId) +", '"+ description +"', '"+date.getSqlFormat()+"')";
-        default:
-            break;
-    }
-
-    return "";
+    this->urgent = urgent;
 }
+
 /**
  * Retourne la représentation de l'objet sour forme de map
  * @return Représentation de l'objet sous forme de map
@@ -130,6 +128,7 @@ std::unordered_map<std::string, std::string> Todo::toMap() const
         { "owner_id", std::to_string(ownerId) },
         { "description", description },
         { "date", date.getSqlFormat()},
+        { "urgent", urgent ? "1" : "0" },
     };
 }
 
@@ -164,6 +163,7 @@ std::ostream &operator<<(std::ostream &os, const Todo &i) {
     os << "; ownerId: " << i.ownerId;
     os << "; description: '" << i.description;
     os << "'; date: " << i.date;
+    os << "; urgent: " << i.urgent;
     os << ">";
     return os;
 }
@@ -176,6 +176,7 @@ Todo::Todo() {
     this->ownerId = -1;
     this->description = "";
     this->date = Date();
+    this->urgent = false;
 }
 
 /**
@@ -189,6 +190,7 @@ Todo::Todo(int ownerId, std::string &description, Date &date) {
     this->ownerId = ownerId;
     this->description = description;
     this->date = date;
+    this->urgent = false;
 }
 
 /**
@@ -228,6 +230,12 @@ Todo Todo::fromMap(std::unordered_map<std::string, std::string> data)
     t.setDescription(data.at("description"));
     t.setDate(Date(data.at("date")));
 
+    // Older exports have no urgent key: undated todos were stored on 01/01/1970
+    if(data.find("urgent") != data.end())
+        t.setUrgent(data.at("urgent") == "1");
+    else
+        t.setUrgent(t.getDate() == Date::fromCivil(1970, 1, 1));
+
     return t;
 }
 
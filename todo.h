@@ -30,6 +30,7 @@ private:
     int ownerId; /*!< Identifiant de la tâche. (Pas d'identifiant -> -1) */
     std::string description; /*!< Description de la tâche à effectuer. */
     Date date; /*!< Date à laquelle la tâche doit être réalisé. Si pas de date -> 1er janvier 1970 (0 secondes) */
+    bool urgent; /*!< Tâche sans date, donc urgente */
 
     // Voir todo.cpp pour la documentation des méthodes
 public:
@@ -41,14 +42,16 @@ public:
 
     void setDescription(std::string& description);
     [[nodiscard]] std::string& getDescription();
+    [[nodiscard]] const std::string& getDescription() const;
 
     [[nodiscard]] Date& getDate();
+    [[nodiscard]] const Date& getDate() const;
     void setDate(const Date& date);
 
-    [[nodiscard]] bool isUrgent();
+    [[nodiscard]] bool isUrgent() const;
+    void setUrgent(bool urgent);
 
 
-    [[nodiscard]] std::string getQuery(int mode);
 
     std::unordered_map<std::string, std::string> toMap() const;
 
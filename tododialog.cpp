@@ -12,6 +12,38 @@
 
 #include "tododialog.h"
 #include "ui_tododialog.h"
+#include <algorithm>
+
+/**
+ * Tâches à afficher selon le mode, lues dans l'index correspondant (sans parcourir toutes les tâches) :
+ *      * toutes : la liste, ou les tâches des contacts choisis fusionnées par date (de la plus récente à la plus ancienne)
+ *      * urgentes : index des tâches sans date
+ *      * en retard : index des échéances, de la plus ancienne à aujourd'hui
+ *      * prochaines : index des échéances, les NEXT_COUNT premières à partir d'aujourd'hui
+ * @return Vue sur les tâches à afficher (avant les filtres de nom et de dates)
+ */
+View<Todo> TodoDialog::source() const
+{
+    if(mode == ALL_TODOS)
+        return owners.empty() ? View<Todo>::of(todos) : todos.getTodosByDate(owners, true);
+
+    const Date now;
+    View<Todo> view;
+    if(mode == URGENT_TODOS)
+        view = todos.getUrgentTodos();
+    else if(mode == OVERDUE_TODOS)
+        view = todos.getOverdueTodos(now);
+    else
+        view = todos.getNextTodos(now, owners.empty() ? NEXT_COUNT : todos.size());
+
+    if(owners.empty())
+        return view;
+
+    // Some contacts only: the limit is applied to their todos
+    const std::vector<int>* ids = &owners;
+    view = view.where([ids](const Todo& t) { return std::binary_search(ids->begin(), ids->end(), t.getOwnerId()); });
+    return mode == NEXT_TODOS ? view.limit(NEXT_COUNT) : view;
+}
 
 /**
  * Actualise l'affichage du QTableWidget avec potentiellement les filtres appliqués
@@ -29,42 +61,43 @@ void TodoDialog::refresh()
                 << "Date"
                 );
 
-    // for all interactions :
-    for(auto& t: todos)
+    // for the todos of the mode :
+    for(const auto& t: source())
     {
         // Prevent access violation
-        Contact* temp = contacts.getContact(t.getOwnerId());
+        const Contact* temp = contacts.getContact(t.getOwnerId());
         if(!temp)
         {
             qDebug() << QString::fromStdString("Propriétaire introuvable pour la todo: " + std::to_string(t.getId()));
             continue;
         }
 
-        Contact owner = *temp;
+        const Contact& owner = *temp;
         std::string searchString = ui->contactNameBox->text().toStdString();
+        char dateBuffer[Date::COMPACT_STRING_SIZE];
+        std::string_view compactDate(dateBuffer, t.getDate().writeDateCompactString(dateBuffer) - dateBuffer);
         if(owner.getFullName().find(searchString) == std::string::npos
                 && t.getDescription().find(searchString) == std::string::npos
-                && t.getDate().getDateCompactString().find(searchString) == std::string::npos)
+                && compactDate.find(searchString) == std::string::npos)
             continue;
 
-        if(urgent && !t.isUrgent()) // Only display urgent todo
-            continue;
+        const bool isUrgent = t.isUrgent();
 
-        if(!urgent && useFrom && t.getDate() < from && !t.isUrgent()) // from
+        if(mode != URGENT_TODOS && useFrom && t.getDate() < from && !isUrgent) // from
             continue;
 
-        if(!urgent && useTo && t.getDate() > to) // to
+        if(mode != URGENT_TODOS && useTo && t.getDate() > to) // to
             continue;
 
         // Display row
         ui->tableWidget->insertRow(ui->tableWidget->rowCount());
         ui->tableWidget->setItem(ui->tableWidget->rowCount()-1, 0, new QTableWidgetItem(QString::number(t.getId())) ); // Set data
-        ui->tableWidget->setItem(ui->tableWidget->rowCount()-1, 1, new QTableWidgetItem(QString::fromStdString(contacts.getContact(t.getOwnerId())->getFullName()))); // Set data
-        ui->tableWidget->item(ui->tableWidget->rowCount()-1, 1)->setToolTip(QString::fromStdString(contacts.getContact(t.getOwnerId())->getFullName()));
+        ui->tableWidget->setItem(ui->tableWidget->rowCount()-1, 1, new QTableWidgetItem(QString::fromStdString(owner.getFullName()))); // Set data
+        ui->tableWidget->item(ui->tableWidget->rowCount()-1, 1)->setToolTip(QString::fromStdString(owner.getFullName()));
         ui->tableWidget->setItem(ui->tableWidget->rowCount()-1, 2, new QTableWidgetItem(QString::fromStdString(t.getDescription()))); // Set data
         ui->tableWidget->item(ui->tableWidget->rowCount()-1, 2)->setToolTip(QString::fromStdString(t.getDescription()));
 
-        if(t.isUrgent()) {
+        if(isUrgent) {
             ui->tableWidget->setItem(ui->tableWidget->rowCount()-1, 3, new QTableWidgetItem("Urgent")); // Set data
         }
         else
@@ -83,7 +116,7 @@ void TodoDialog::refresh()
     ui->tableWidget->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
 
     if(currentViewId != -1) {
-        Contact c = *contacts.getContact(todos.getTodo(currentViewId)->getOwnerId());
+        const Contact& c = *contacts.getContact(todos.getTodo(currentViewId)->getOwnerId());
         ui->viewNoteText->setPlainText(QString::fromStdString(c.getNote()));
     }
 }
@@ -135,22 +168,22 @@ void TodoDialog::on_toEditBox_textChanged(const QString &text)
 }
 
 /**
- * Actualise l'affichage quand on active le mode qui permet de voir exclusivement les tâches urgentes (sans date)
+ * Actualise l'affichage quand on change de mode : les dates ne filtrent pas les tâches urgentes (sans date)
  */
-void TodoDialog::urgentDisplayUpdate()
+void TodoDialog::modeDisplayUpdate()
 {
-    ui->toEditBox->setEnabled(!urgent);
-    ui->fromEditBox->setEnabled(!urgent);
+    ui->toEditBox->setEnabled(mode != URGENT_TODOS);
+    ui->fromEditBox->setEnabled(mode != URGENT_TODOS);
 }
 
 /**
- * Quand l'utilisateur coche/décoche la case permettant d'afficher ou non exclusivement les tâches urgentes (sans date)
- * @param checked
+ * Quand l'utilisateur choisit les tâches à afficher (toutes, urgentes, en retard ou prochaines échéances)
+ * @param index Index du mode dans la liste déroulante (voir Mode)
  */
-void TodoDialog::on_urgentOnly_stateChanged(int checked)
+void TodoDialog::on_modeBox_currentIndexChanged(int index)
 {
-    urgent = (bool)checked;
-    urgentDisplayUpdate();
+    mode = static_cast<Mode>(index);
+    modeDisplayUpdate();
     refresh();
 }
 
@@ -164,33 +197,37 @@ void TodoDialog::on_tableWidget_cellActivated(int row, __attribute__((unused)) i
 {
     ui->tableWidget->selectRow(row);
     currentViewId = ui->tableWidget->item(row, 0)->text().toInt();
-    Contact c = *contacts.getContact(todos.getTodo(currentViewId)->getOwnerId());
+    const Contact& c = *contacts.getContact(todos.getTodo(currentViewId)->getOwnerId());
     ui->viewNoteText->setPlainText(QString::fromStdString(c.getNote()));
 }
 
 /**
  * Constructeur de la classe TodoDialog.
- * @param cs Liste des contacts avec leurs tâches
+ * Les listes ne sont pas copiées : elles doivent survivre à la fenêtre.
+ * @param cs Liste des contacts
+ * @param ts Liste des tâches des contacts
  * @param parent Fenêtre parente
+ * @param ownerIds Contacts dont on affiche les tâches (vide par défaut: tous les contacts)
  */
-TodoDialog::TodoDialog(Contacts cs, QWidget *parent) :
+TodoDialog::TodoDialog(const Contacts& cs, const Todos& ts, QWidget *parent, std::vector<int> ownerIds) :
     QDialog(parent),
     contacts(cs),
+    todos(ts),
+    owners(std::move(ownerIds)),
     ui(new Ui::TodoDialog)
 {
     ui->setupUi(this);
-    urgent = false;
+    std::sort(owners.begin(), owners.end());
+    mode = ALL_TODOS;
     useTo = false;
     useFrom = false;
     nameFilter = "";
     currentViewId = -1;
     ui->viewNoteText->setEnabled(false);
-    setWindowTitle("Consulation des rendez-vous");
-
-    // Register all todos:
-    for(const auto& c : contacts)
-        for(const auto& t: c.getTodos())
-            todos.addTodo(t);
+    if(owners.empty())
+        setWindowTitle("Consulation des rendez-vous");
+    else
+        setWindowTitle("Consulation des rendez-vous: " + QString::number(static_cast<int>(owners.size())) + " contact(s)");
 
     initCompleter();
     refresh();
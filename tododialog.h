@@ -24,30 +24,45 @@ class TodoDialog;
  *      * Nom du contact
  *      * Date minimum
  *      * Date maximum
- *      * Afficher exclusivement les rendez-vous urgents
+ *      * Afficher exclusivement les rendez-vous urgents, en retard ou les prochaines échéances
  * Classe permettant l'affichage des différentes tâches avec plusieurs filtres
  */
 class TodoDialog : public QDialog
 {
     Q_OBJECT
 
+public:
+    /**
+     * Tâches affichées (dans l'ordre de la liste déroulante)
+     */
+    enum Mode
+    {
+        ALL_TODOS, /*!< Toutes les tâches */
+        URGENT_TODOS, /*!< Tâches urgentes (sans date) */
+        OVERDUE_TODOS, /*!< Tâches dont l'échéance est passée */
+        NEXT_TODOS /*!< Prochaines échéances (NEXT_COUNT au plus) */
+    };
+    static constexpr std::size_t NEXT_COUNT = 10; /*!< Nombre de prochaines échéances affichées */
+
 private:
     int currentViewId; /*!< Index du TODO selectionne */
-    bool urgent; /*!< Affichage des tâches urgentes uniquement */
+    Mode mode; /*!< Tâches affichées */
     bool useFrom; /*!< Filtrer avec une date de début */
     bool useTo; /*!< Filtrer avec une date de fin */
     Date from; /*!< Date de début de recherche */
     Date to; /*!< Date de fin de recherche */
     std::string nameFilter; /*!< Nom a rechercher */
-    Contacts contacts; /*!< Listes des contacts */
-    Todos todos; /*!< Listes des tâches */
+    const Contacts& contacts; /*!< Listes des contacts (cache de l'application) */
+    const Todos& todos; /*!< Listes des tâches (cache de l'application) */
+    std::vector<int> owners; /*!< Contacts dont on affiche les tâches, triés (vide: tous les contacts) */
 
     void initCompleter();
+    [[nodiscard]] View<Todo> source() const;
     void refresh();
-    void urgentDisplayUpdate();
+    void modeDisplayUpdate();
 
 public:
-    explicit TodoDialog(Contacts cs, QWidget *parent = nullptr);
+    explicit TodoDialog(const Contacts& cs, const Todos& ts, QWidget *parent = nullptr, std::vector<int> ownerIds = {});
     ~TodoDialog();
 
 private slots:
@@ -55,7 +70,7 @@ private slots:
     void on_fromEditBox_textChanged(const QString &text);
     void on_toEditBox_textChanged(const QString &text);
 
-    void on_urgentOnly_stateChanged(int checked);
+    void on_modeBox_currentIndexChanged(int index);
 
     void on_tableWidget_cellActivated(int row, int column);
 
@@ -12,14 +12,7 @@
  */
 
 #include "todos.h"
-
-/**
- * Itérateur qui pointe sur le début de la liste
- * @return Itérateur (début)
- */
-Todos::iterator Todos::begin() {
-    return this->todos.begin();
-}
+#include <memory>
 
 /**
  * Itérateur constant qui pointe sur le début de la liste
@@ -30,19 +23,19 @@ Todos::const_iterator Todos::begin() const {
 }
 
 /**
- * Itérateur qui ponte sur la fin de la liste
+ * Itérateur constant qui pointe sur la fin de la liste
  * @return Itérateur (fin)
  */
-Todos::iterator Todos::end() {
+Todos::const_iterator Todos::end() const {
     return this->todos.end();
 }
 
 /**
- * Itérateur constant qui pointe sur la fin de la liste
- * @return Itérateur (fin)
+ * Réserve la place pour un nombre de Todo donné (évite les réallocations lors d'un chargement)
+ * @param count Nombre de Todo attendus
  */
-Todos::const_iterator Todos::end() const {
-    return this->todos.end();
+void Todos::reserve(std::size_t count) {
+    this->todos.reserve(count);
 }
 
 /**
@@ -52,41 +45,45 @@ void Todos::clear() {
     this->todos.clear();
 }
 
+/**
+ * Échange le contenu de deux listes (et leurs index), sans copie
+ * @param other Autre liste
+ */
+void Todos::swap(Todos& other) {
+    std::swap(this->todos, other.todos);
+}
 
 /**
- * Ajoute une tâche à la liste
+ * Ajoute une tâche à la liste.
+ * Si une tâche avec le même identifiant existe déjà, elle est remplacée.
  * @param t Tâche à ajouter
  */
 void Todos::addTodo(const Todo &t) {
-    this->todos.push_back(t);
+    this->todos.add(t);
 }
 
 /**
- * Tri les tâches par ordre chronologique
+ * Tri les tâches de la liste par ordre chronologique (les index, eux, sont toujours triés)
  * @param reverse Ordre inversé ? (false par défaut)
  */
 void Todos::sortByDate(bool reverse) {
     if(reverse)
-        this->todos.sort([](Todo t, Todo &t1) {return t.getDate() > t1.getDate();});
+        this->todos.sort([](const Todo &t, const Todo &t1) {return t.getDate() > t1.getDate();});
     else
-        this->todos.sort([](Todo &t,  Todo &t1) {return t.getDate() < t1.getDate();});
-
+        this->todos.sort([](const Todo &t, const Todo &t1) {return t.getDate() < t1.getDate();});
 }
 
 /**
- * Retire la première tâche trouvée avec l'identifiant précisé
+ * Retire la tâche avec l'identifiant précisé.
+ * La dernière tâche prend la place de celle supprimée (l'ordre de la liste n'est pas conservé).
  * @param id Identifiant de la tâche
  */
 void Todos::remove(int id) {
-    for(const auto& t : this->todos)
-        if(t.getId() == id) {
-            this->todos.remove(t);
-            return; // Return to prevent access violation
-        }
+    this->todos.remove(id);
 }
 
 /**
- * Retire une tâche de la liste
+ * Retire une tâche de la liste (toutes les tâches égales si elle n'a pas d'identifiant)
  * @param t Tâche à retirer (Todo)
  */
 void Todos::remove(const Todo& t) {
@@ -98,46 +95,149 @@ void Todos::remove(const Todo& t) {
  * @return Nombre d'éléments dans la liste
  */
 unsigned int Todos::size() const{
-    return this->todos.size();
+    return static_cast<unsigned int>(this->todos.size());
 }
 
 /**
- * Renvoie un pointeur sur la première tâche trouvé avec l'identifiant id
+ * Renvoie un pointeur constant sur la tâche avec l'identifiant id
  * @param id Identifiant de la tâche à chercher
- * @return Tâche avec l'identifiant id
+ * @return Tâche avec l'identifiant id (nullptr si non trouvée)
+ */
+const Todo* Todos::getTodo(int id) const {
+    return this->todos.get(id);
+}
+
+/**
+ * Renvoie une vue sur les tâches d'un propriétaire (Contact), sans copie, par ordre chronologique
+ * @param ownerId Identifiant du propriétaire
+ * @param reverse Du plus récent au plus ancien ? (false par défaut)
+ * @return Vue sur les tâches du propriétaire
  */
-Todo* Todos::getTodo(int id) {
-    for(auto& t : this->todos)
-        if(t.getId() == id)
-            return &t;
-    return nullptr;
+View<Todo> Todos::getTodosOf(int ownerId, bool reverse) const {
+    const Store* store = &this->todos;
+    if(reverse)
+        return store->view([store, ownerId]() {
+            return DateIndex::reverse(store->index<ByOwner>().of(ownerId).all());
+        });
+    return store->view([store, ownerId]() { return store->index<ByOwner>().of(ownerId).all(); });
 }
 
 /**
- * Renvoie une liste todos de todo avec les tâches comprises entre les deux dates
+ * Renvoie une vue sur les tâches d'un propriétaire (Contact) comprises entre deux dates, par ordre chronologique
+ * @param ownerId Identifiant du propriétaire
  * @param to Date de début de recherche
  * @param from Date de fin de recherche
- * @return Liste
+ * @return Vue sur les tâches concernées
  */
-Todos Todos::getTodosBetween(Date &to, Date &from) {
-    Todos ts{};
-    for(auto& t: this->todos)
-        if(t.getDate() >= to && t.getDate() <= from)
-            ts.addTodo(t);
-    return ts;
+View<Todo> Todos::getTodosOfBetween(int ownerId, const Date &to, const Date &from) const {
+    const Store* store = &this->todos;
+    const std::int64_t first = to.getEpoch(), last = from.getEpoch();
+    return store->view([store, ownerId, first, last]() {
+        return store->index<ByOwner>().of(ownerId).between(first, last);
+    });
 }
 
 /**
- * Retourne les tâches sans date, et donc importantes
- * @return Tâches sans date.
+ * Renvoie le nombre de tâches d'un propriétaire (Contact)
+ * @param ownerId Identifiant du propriétaire
+ * @return Nombre de tâches
  */
-Todos Todos::getUrgentTodos() {
-    Todos ts;
-    for(auto& t: this->todos) {
-        if(t.getDate().getTotalSeconds() == -1)
-            ts.addTodo(t);
-    }
-    return ts;
+std::size_t Todos::countOf(int ownerId) const {
+    return this->todos.index<ByOwner>().of(ownerId).size();
+}
+
+/**
+ * Renvoie une vue sur les tâches comprises entre les deux dates (sans copie, évaluée au parcours).
+ * Les tâches sont lues dans l'index des dates, par ordre chronologique ; la liste n'est parcourue entièrement que si
+ * elle contient des tâches sans identifiant (non indexées).
+ * @param to Date de début de recherche
+ * @param from Date de fin de recherche
+ * @return Vue sur les tâches concernées
+ */
+View<Todo> Todos::getTodosBetween(const Date &to, const Date &from) const {
+    if(!this->todos.isIndexed())
+        return View<Todo>::of(this->todos).where([to, from](const Todo& t) {
+            return t.getDate() >= to && t.getDate() <= from;
+        });
+
+    const Store* store = &this->todos;
+    const std::int64_t first = to.getEpoch(), last = from.getEpoch();
+    return store->view([store, first, last]() { return store->index<ByDate>().get().between(first, last); });
+}
+
+/**
+ * Renvoie une vue sur toutes les tâches (avec identifiant) par ordre chronologique, lue dans l'index des dates :
+ * rien n'est copié ni trié.
+ * @param reverse Du plus récent au plus ancien ? (false par défaut)
+ * @return Vue chronologique sur les tâches
+ */
+View<Todo> Todos::getTodosByDate(bool reverse) const {
+    const Store* store = &this->todos;
+    if(reverse)
+        return store->view([store]() { return DateIndex::reverse(store->index<ByDate>().get().all()); });
+    return store->view([store]() { return store->index<ByDate>().get().all(); });
+}
+
+/**
+ * Renvoie une vue chronologique sur les tâches de plusieurs propriétaires.
+ * Les index (déjà triés) de chaque propriétaire sont fusionnés au fur et à mesure du parcours (fusion k-aire) : le
+ * premier élément est disponible sans trier l'ensemble.
+ * @param ownerIds Identifiants des propriétaires
+ * @param reverse Du plus récent au plus ancien ? (false par défaut)
+ * @return Vue chronologique sur les tâches des propriétaires
+ */
+View<Todo> Todos::getTodosByDate(std::vector<int> ownerIds, bool reverse) const {
+    const Store* store = &this->todos;
+    auto owners = std::make_shared<const std::vector<int>>(std::move(ownerIds));
+    if(reverse)
+        return store->merge(
+            [store, owners]() {
+                std::vector<DateIndex::ReverseRange> runs;
+                for(const auto& run : store->index<ByOwner>().runsOf(*owners))
+                    runs.push_back(DateIndex::reverse(run));
+                return runs;
+            },
+            DateIndex::After());
+    return store->merge([store, owners]() { return store->index<ByOwner>().runsOf(*owners); }, DateIndex::Before());
+}
+
+/**
+ * Retourne une vue sur les tâches sans date, et donc importantes.
+ * Les tâches urgentes sont lues dans leur index (O(k)) ; la liste n'est parcourue entièrement que si elle contient
+ * des tâches sans identifiant (non indexées).
+ * @return Vue sur les tâches sans date.
+ */
+View<Todo> Todos::getUrgentTodos() const {
+    if(!this->todos.isIndexed())
+        return View<Todo>::of(this->todos).where([](const Todo& t) { return t.isUrgent(); });
+
+    const Store* store = &this->todos;
+    return store->view([store]() { return store->index<UrgentIds>().all(); });
+}
+
+/**
+ * Retourne une vue sur les tâches (avec identifiant) en retard : non urgentes et dont l'échéance est passée, de la
+ * plus ancienne à la plus récente
+ * @param now Date actuelle
+ * @return Vue sur les tâches en retard
+ */
+View<Todo> Todos::getOverdueTodos(const Date &now) const {
+    const Store* store = &this->todos;
+    const std::int64_t epoch = now.getEpoch();
+    return store->view([store, epoch]() { return store->index<ByDueDate>().before(epoch); });
+}
+
+/**
+ * Retourne une vue sur les prochaines échéances : les count premières tâches (avec identifiant, non urgentes) à
+ * partir d'une date, par ordre chronologique
+ * @param now Date actuelle (incluse)
+ * @param count Nombre maximal de tâches
+ * @return Vue sur les prochaines tâches
+ */
+View<Todo> Todos::getNextTodos(const Date &now, std::size_t count) const {
+    const Store* store = &this->todos;
+    const std::int64_t epoch = now.getEpoch();
+    return store->view([store, epoch]() { return store->index<ByDueDate>().from(epoch); }).limit(count);
 }
 
 /**
@@ -169,6 +269,7 @@ Todos &operator+=(Todos &ts, const Todo &t) {
  * @return Liste ts avec les Todos en plus
  */
 Todos &operator+=(Todos &ts, const Todos &t) {
+    ts.todos.reserve(ts.todos.size() + t.todos.size());
     for(auto& todo : t.todos)
         ts.addTodo(todo);
     return ts;
@@ -214,16 +315,16 @@ std::ostream& operator<<(std::ostream& os, const Todos& ts) {
 /**
  * Constructeur de la classe (initialise une liste vide)
  */
-Todos::Todos() {
-    this->todos = std::list<Todo>();
-}
+Todos::Todos() = default;
 
 /**
  * Constructeur de la classe avec une liste de tâche (copie la liste dans la nouvelle structure)
  * @param todos Liste de tâche
  */
 Todos::Todos(std::list<Todo> todos) {
-    this->todos = std::move(todos);
+    this->todos.reserve(todos.size());
+    for(auto& t : todos)
+        addTodo(t);
 }
 
 /**
@@ -231,8 +332,7 @@ Todos::Todos(std::list<Todo> todos) {
  * @param todo Tache avec laquelle initialiser la liste
  */
 Todos::Todos(const Todo& todo) {
-    this->todos = std::list<Todo>();
-    this->todos.push_back(todo);
+    addTodo(todo);
 }
 
 /**
@@ -256,27 +356,22 @@ Todos Todos::extractFromString(std::string str) {
             std::size_t index = line.find("@date");
             if(index != std::string::npos && line.size() >= index+16) // check length
             {
-                std::string temp_date = line.substr(index+6, 10);
-                std::smatch match;
-                std::regex regex{R"(\d\d/\d\d/\d\d\d\d)"};
-                if(std::regex_search(temp_date, match, regex)) { // Check for format
-                    Date d(temp_date, true);
+                Date d(std::string_view(line).substr(index+6, 10), true);
+                if(d.isValid()) { // Check for format
                     description = line.substr(5, index-6);
                     t.setDate(d);
                 }
-                else // invalid -> create with 0 sec
+                else // invalid -> urgent, stored on 01/01/1970
                 {
-                    std::string date = "01/01/1970";
-                    Date d(date, true);
-                    t.setDate(d);
+                    t.setDate(Date::fromCivil(1970, 1, 1));
+                    t.setUrgent(true);
                     description = line.substr(5);
                 }
             }
-            else // no date -> create with 0 sec
+            else // no date -> urgent, stored on 01/01/1970
             {
-                std::string date = "01/01/1970";
-                Date d(date, true);
-                t.setDate(d);
+                t.setDate(Date::fromCivil(1970, 1, 1));
+                t.setUrgent(true);
                 description = line.substr(5);
             }
             t.setDescription(description);
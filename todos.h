@@ -15,19 +15,31 @@
 #define CDAA_TODOS_H
 
 #include <list> // std::list
+#include <vector>
+#include <unordered_map>
+#include "dateindex.h"
+#include "entitystore.h"
 #include "todo.h"
+#include "view.h"
 #include <utility> // std::move
 #include <cstdarg> // va
-#include <regex> // check date
 #include <sstream> // istringstream
 
 /**
  * Classe permettant de modéliser une liste de tâches (Todo) plus adaptée à notre application.
+ * Les tâches sont stockées de manière contiguë et indexées par identifiant, par date et par propriétaire (Contact), voir
+ * EntityStore : la liste de l'application contient chaque tâche une seule fois, un Contact y accède par getTodosOf().
+ * Les recherches entre deux dates (getTodosBetween, getTodosOfBetween) ne parcourent que les tâches concernées.
+ * Les tâches urgentes et les échéances des autres tâches sont tenues à jour à chaque ajout, remplacement ou
+ * suppression : tâches urgentes, en retard ou prochaines échéances s'obtiennent sans parcourir toute la liste.
+ * Seules les tâches qui ont un identifiant (>= 0) sont indexées. L'identifiant ou le propriétaire d'une tâche de la
+ * liste se modifie en la remplaçant (addTodo) : getTodo() et les itérateurs sont constants.
  * @brief Classe permettant de modéliser une liste de Todo
  */
 class Todos {
 private:
-    std::list<Todo> todos; /*!< Listes des tâches (Todo) à modéliser */
+    using Store = EntityStore<Todo, ByDate, ByOwner, UrgentIds, ByDueDate>; /*!< Index utilisés par la liste */
+    Store todos; /*!< Listes des tâches (Todo) à modéliser (stockage contigu et index) */
 
 public:
     // Voir todos.cpp pour la documentation des méthodes
@@ -38,19 +50,25 @@ public:
     void remove(const Todo& t);
 
     void clear();
+    void reserve(std::size_t count);
+    void swap(Todos& other);
 
     [[nodiscard]] unsigned int size() const;
 
-    [[nodiscard]] Todo* getTodo(int id);
-    [[nodiscard]] Todos getTodosBetween(Date& to, Date& from);
-    [[nodiscard]] Todos getUrgentTodos();
+    [[nodiscard]] const Todo* getTodo(int id) const;
+    [[nodiscard]] View<Todo> getTodosOf(int ownerId, bool reverse=false) const;
+    [[nodiscard]] std::size_t countOf(int ownerId) const;
+    [[nodiscard]] View<Todo> getTodosOfBetween(int ownerId, const Date& to, const Date& from) const;
+    [[nodiscard]] View<Todo> getTodosBetween(const Date& to, const Date& from) const;
+    [[nodiscard]] View<Todo> getTodosByDate(bool reverse=false) const;
+    [[nodiscard]] View<Todo> getTodosByDate(std::vector<int> ownerIds, bool reverse=false) const;
+    [[nodiscard]] View<Todo> getUrgentTodos() const;
+    [[nodiscard]] View<Todo> getOverdueTodos(const Date& now) const;
+    [[nodiscard]] View<Todo> getNextTodos(const Date& now, std::size_t count) const;
 
     // Iteration
-    using iterator = std::list<Todo>::iterator;
-    using const_iterator = std::list<Todo>::const_iterator;
-    iterator begin();
+    using const_iterator = std::vector<Todo>::const_iterator;
     const_iterator begin() const;
-    iterator end();
     const_iterator end() const;
 
     // Surcharges d'opérateurs
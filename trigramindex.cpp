@@ -0,0 +1,180 @@
+/**
+ * @file trigramindex.cpp
+ *
+ * @brief Définition de la classe TrigramIndex (recherche de sous-chaînes dans les contacts)
+ *
+ * @version 1.0
+ *
+ * @author LEESTMANS Richard
+ * @author COUDERT Nicolas
+ */
+
+#include "trigramindex.h"
+#include "utils.h"
+#include <algorithm>
+
+/**
+ * Renvoie les trigrammes distincts d'un texte replié, chacun codé sur un entier (3 octets).
+ * @param folded Texte replié
+ * @return Trigrammes triés, sans doublon
+ */
+std::vector<std::uint32_t> TrigramIndex::trigramsOf(const std::string& folded)
+{
+    std::vector<std::uint32_t> trigrams;
+    if(folded.size() < 3)
+        return trigrams;
+
+    trigrams.reserve(folded.size() - 2);
+    for(std::size_t i = 0; i + 2 < folded.size(); i++)
+        trigrams.push_back(static_cast<std::uint32_t>(static_cast<unsigned char>(folded[i])) << 16
+                           | static_cast<std::uint32_t>(static_cast<unsigned char>(folded[i + 1])) << 8
+                           | static_cast<std::uint32_t>(static_cast<unsigned char>(folded[i + 2])));
+
+    std::sort(trigrams.begin(), trigrams.end());
+    trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+    return trigrams;
+}
+
+/**
+ * Vérifie qu'un document contient le texte recherché dans l'un des champs demandés.
+ * @param document Champs repliés du document
+ * @param folded Texte recherché (replié)
+ * @param fields Champs où chercher (combinaison de Field)
+ * @return Si le texte est trouvé
+ */
+bool TrigramIndex::matches(const Document& document, const std::string& folded, unsigned int fields)
+{
+    for(std::size_t f = 0; f < FIELD_COUNT; f++)
+        if((fields & (1u << f)) && document[f].find(folded) != std::string::npos)
+            return true;
+    return false;
+}
+
+/**
+ * Ajoute (ou remplace) un document dans l'index.
+ * @param id Identifiant du document
+ * @param name Nom complet
+ * @param company Entreprise
+ * @param email Adresse email
+ * @param phone Numéro de téléphone
+ * @param creation Date de création (dd/mm/yyyy, voir Date::getDateCompactString)
+ */
+void TrigramIndex::add(int id, const std::string& name, const std::string& company, const std::string& email,
+                       const std::string& phone, const std::string& creation)
+{
+    remove(id);
+
+    Document& document = this->documents[id];
+    document = { Utils::fold(name), Utils::fold(company), Utils::fold(email), Utils::fold(phone), std::to_string(id),
+                 creation };
+
+    std::vector<std::uint32_t> trigrams;
+    for(const auto& field : document) {
+        std::vector<std::uint32_t> t = trigramsOf(field);
+        trigrams.insert(trigrams.end(), t.begin(), t.end());
+    }
+    std::sort(trigrams.begin(), trigrams.end());
+    trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+
+    for(std::uint32_t trigram : trigrams) {
+        std::vector<int>& ids = this->postings[trigram];
+        // Identifiers usually come in increasing order (loading): append without searching
+        if(ids.empty() || ids.back() < id)
+            ids.push_back(id);
+        else
+            ids.insert(std::lower_bound(ids.begin(), ids.end(), id), id);
+    }
+}
+
+/**
+ * Retire un document de l'index (ne fait rien s'il n'est pas indexé).
+ * @param id Identifiant du document
+ */
+void TrigramIndex::remove(int id)
+{
+    auto document = this->documents.find(id);
+    if(document == this->documents.end())
+        return;
+
+    for(const auto& field : document->second) {
+        for(std::uint32_t trigram : trigramsOf(field)) {
+            auto posting = this->postings.find(trigram);
+            if(posting == this->postings.end())
+                continue; // Already removed (trigram shared by two fields)
+
+            std::vector<int>& ids = posting->second;
+            auto it = std::lower_bound(ids.begin(), ids.end(), id);
+            if(it != ids.end() && *it == id)
+                ids.erase(it);
+            if(ids.empty())
+                this->postings.erase(posting);
+        }
+    }
+
+    this->documents.erase(document);
+}
+
+/**
+ * Vide l'index
+ */
+void TrigramIndex::clear()
+{
+    this->documents.clear();
+    this->postings.clear();
+}
+
+/**
+ * Renvoie le nombre de documents indexés
+ * @return Nombre de documents
+ */
+std::size_t TrigramIndex::size() const
+{
+    return this->documents.size();
+}
+
+/**
+ * Cherche les documents dont l'un des champs demandés contient un texte (sans tenir compte de la casse ni des
+ * accents). Une requête de moins de 3 caractères n'a pas de trigramme : tous les documents sont alors parcourus.
+ * @param text Texte recherché
+ * @param fields Champs où chercher (combinaison de Field)
+ * @return Identifiants des documents trouvés, triés
+ */
+std::vector<int> TrigramIndex::search(const std::string& text, unsigned int fields) const
+{
+    const std::string folded = Utils::fold(text);
+    std::vector<int> found;
+
+    const std::vector<std::uint32_t> trigrams = trigramsOf(folded);
+    if(trigrams.empty())
+    {
+        for(const auto& document : this->documents)
+            if(matches(document.second, folded, fields))
+                found.push_back(document.first);
+        std::sort(found.begin(), found.end());
+        return found;
+    }
+
+    // Posting lists of every trigram, smallest first
+    std::vector<const std::vector<int>*> lists;
+    lists.reserve(trigrams.size());
+    for(std::uint32_t trigram : trigrams) {
+        auto posting = this->postings.find(trigram);
+        if(posting == this->postings.end())
+            return found;
+        lists.push_back(&posting->second);
+    }
+    std::sort(lists.begin(), lists.end(),
+              [](const std::vector<int>* a, const std::vector<int>* b) { return a->size() < b->size(); });
+
+    // Intersect, then check that the trigrams are contiguous in one of the requested fields
+    for(int id : *lists.front()) {
+        bool candidate = true;
+        for(std::size_t l = 1; l < lists.size() && candidate; l++)
+            candidate = std::binary_search(lists[l]->begin(), lists[l]->end(), id);
+
+        if(candidate && matches(this->documents.at(id), folded, fields))
+            found.push_back(id);
+    }
+
+    return found;
+}
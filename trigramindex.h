@@ -0,0 +1,66 @@
+/**
+ * @file trigramindex.h
+ *
+ * @brief Déclaration de la classe TrigramIndex (recherche de sous-chaînes dans les contacts)
+ *
+ * @author LEESTMANS Richard
+ * @author COUDERT Nicolas
+ */
+
+#ifndef CDAA_TRIGRAMINDEX_H
+#define CDAA_TRIGRAMINDEX_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Index inversé de trigrammes (suites de 3 octets) sur les champs texte d'un ensemble de documents identifiés par
+ * un entier. Les textes sont repliés (minuscules, sans accent, voir Utils::fold) : la recherche ne tient compte ni de
+ * la casse ni des accents.
+ * Une recherche intersecte les listes des trigrammes de la requête puis vérifie chaque candidat : seuls les
+ * documents qui contiennent tous les trigrammes de la requête sont comparés.
+ * \brief Index de trigrammes pour la recherche de sous-chaînes
+ */
+class TrigramIndex
+{
+public:
+    /**
+     * Champs indexés (combinables pour une recherche)
+     */
+    enum Field : unsigned int
+    {
+        NAME = 1 << 0, /*!< Nom complet */
+        COMPANY = 1 << 1, /*!< Entreprise */
+        EMAIL = 1 << 2, /*!< Adresse email */
+        PHONE = 1 << 3, /*!< Numéro de téléphone */
+        ID = 1 << 4, /*!< Identifiant (en décimal) */
+        CREATION = 1 << 5, /*!< Date de création (dd/mm/yyyy) */
+        ALL = NAME | COMPANY | EMAIL | PHONE | ID | CREATION /*!< Tous les champs */
+    };
+
+private:
+    static constexpr std::size_t FIELD_COUNT = 6; /*!< Nombre de champs indexés */
+
+    using Document = std::array<std::string, FIELD_COUNT>; /*!< Champs repliés d'un document */
+
+    std::unordered_map<int, Document> documents; /*!< Champs repliés de chaque document, par identifiant */
+    std::unordered_map<std::uint32_t, std::vector<int>> postings; /*!< Identifiants triés des documents, par trigramme */
+
+    static std::vector<std::uint32_t> trigramsOf(const std::string& folded);
+    static bool matches(const Document& document, const std::string& folded, unsigned int fields);
+
+public:
+    // Voir trigramindex.cpp pour la documentation des méthodes
+    void add(int id, const std::string& name, const std::string& company, const std::string& email,
+             const std::string& phone, const std::string& creation);
+    void remove(int id);
+    void clear();
+    [[nodiscard]] std::size_t size() const;
+
+    [[nodiscard]] std::vector<int> search(const std::string& text, unsigned int fields=ALL) const;
+};
+
+#endif // CDAA_TRIGRAMINDEX_H
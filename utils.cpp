@@ -12,36 +12,35 @@
 #include "utils.h"
 
 /**
- * Sécurise une string pour la base de données.
- * @brief Utils::addSlashes Sécuisation de string
- * @param s String à sécuriser
+ * Équivalent sans accent (et en minuscules) des caractères U+00C0 à U+017F (Latin-1 et Latin étendu A).
+ * nullptr si le caractère n'est pas une lettre (il est alors conservé tel quel).
  */
-void Utils::addSlashes(std::string& s)
-{
-    // Chars found on stackoverflow and addlshases function in python language
-    std::vector<char> charToCancel = {'\\', '\'', '"'};
-    std::vector<char> charToDelete = {'\r', '\x1A'};
-
-    for (auto i = s.begin();;) {
-        auto const pos = std::find_if(
-            i, s.end(),
-            [charToCancel](char const c) { return std::count(charToCancel.begin(), charToCancel.end(), c); }
-        );
-        if (pos == s.end()) {
-            break;
-        }
-        i = std::next(s.insert(pos, '\\'), 2);
-    }
-
-    s.erase(
-        std::remove_if(
-            s.begin(), s.end(), [charToDelete](char const c) {
-                return std::count(charToDelete.begin(), charToDelete.end(), c);
-            }
-        ),
-        s.end()
-    );
-}
+static const char* const FOLDED_LATIN[] = {
+    "a", "a", "a", "a", "a", "a", "ae", "c",
+    "e", "e", "e", "e", "i", "i", "i", "i",
+    "d", "n", "o", "o", "o", "o", "o", nullptr,
+    "o", "u", "u", "u", "u", "y", "th", "ss",
+    "a", "a", "a", "a", "a", "a", "ae", "c",
+    "e", "e", "e", "e", "i", "i", "i", "i",
+    "d", "n", "o", "o", "o", "o", "o", nullptr,
+    "o", "u", "u", "u", "u", "y", "th", "y",
+    "a", "a", "a", "a", "a", "a", "c", "c",
+    "c", "c", "c", "c", "c", "c", "d", "d",
+    "d", "d", "e", "e", "e", "e", "e", "e",
+    "e", "e", "e", "e", "g", "g", "g", "g",
+    "g", "g", "g", "g", "h", "h", "h", "h",
+    "i", "i", "i", "i", "i", "i", "i", "i",
+    "i", "i", "ij", "ij", "j", "j", "k", "k",
+    "k", "l", "l", "l", "l", "l", "l", "l",
+    "l", "l", "l", "n", "n", "n", "n", "n",
+    "n", "n", "n", "n", "o", "o", "o", "o",
+    "o", "o", "oe", "oe", "r", "r", "r", "r",
+    "r", "r", "s", "s", "s", "s", "s", "s",
+    "s", "s", "t", "t", "t", "t", "t", "t",
+    "u", "u", "u", "u", "u", "u", "u", "u",
+    "u", "u", "u", "u", "w", "w", "y", "y",
+    "y", "z", "z", "z", "z", "z", "z", "s",
+};
 
 /**
  * Vérifie qu'une date est correct (string) et la stock dans un objet Date
@@ -62,3 +61,59 @@ bool Utils::checkForDate(std::string s, Date* d)
 
     return false;
 }
+
+/**
+ * Renvoie une version "repliée" d'une chaîne UTF-8 : lettres ASCII en minuscules, lettres latines accentuées
+ * remplacées par leur équivalent sans accent (é -> e, Ç -> c, œ -> oe...). Les autres caractères sont conservés.
+ * @param s Chaîne UTF-8 à replier
+ * @return Chaîne repliée
+ */
+std::string Utils::fold(const std::string& s)
+{
+    std::string folded;
+    folded.reserve(s.size());
+
+    for(std::size_t i = 0; i < s.size(); i++)
+    {
+        auto c = static_cast<unsigned char>(s[i]);
+        if(c < 0x80) {
+            folded += static_cast<char>(c >= 'A' && c <= 'Z' ? c - 'A' + 'a' : c);
+            continue;
+        }
+
+        // Two bytes sequence (U+0080 to U+07FF)
+        if((c & 0xE0) == 0xC0 && i + 1 < s.size() && (static_cast<unsigned char>(s[i + 1]) & 0xC0) == 0x80)
+        {
+            unsigned int codePoint = ((c & 0x1F) << 6) | (static_cast<unsigned char>(s[i + 1]) & 0x3F);
+            if(codePoint >= 0xC0 && codePoint < 0x180 && FOLDED_LATIN[codePoint - 0xC0]) {
+                folded += FOLDED_LATIN[codePoint - 0xC0];
+                i++;
+                continue;
+            }
+        }
+
+        folded += static_cast<char>(c);
+    }
+
+    return folded;
+}
+
+/**
+ * Construit la clé de tri d'un nom : la comparaison octet par octet (memcmp) de deux clés donne l'ordre
+ * alphabétique français (nom puis prénom, sans tenir compte des accents ni de la casse).
+ * Les noms qui ne diffèrent que par les accents ou la casse sont départagés par leur forme d'origine.
+ * @param lastName Nom de famille
+ * @param firstName Prénom
+ * @return Clé de tri
+ */
+std::string Utils::collationKey(const std::string& lastName, const std::string& firstName)
+{
+    std::string key = fold(lastName);
+    key += '\x01'; // Sorts before any character: "Dupont" < "Dupontel"
+    key += fold(firstName);
+    key += '\0';
+    key += lastName;
+    key += '\x01';
+    key += firstName;
+    return key;
+}
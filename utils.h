@@ -32,7 +32,8 @@ enum DBTodoSubTypes
 {
     UPDATE, // 0
     DELETE, // 1
-    CREATE  // 2
+    CREATE, // 2
+    LOAD    // 3 (lecture de l'historique d'un contact, jamais mise en attente)
 };
 
 /**
@@ -53,8 +54,9 @@ typedef struct DB_t
 class Utils
 {
 public:
-    static void addSlashes(std::string& s);
     static bool checkForDate(std::string s, Date* d);
+    static std::string fold(const std::string& s);
+    static std::string collationKey(const std::string& lastName, const std::string& firstName);
 };
 
 #endif // UTILS_H
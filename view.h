@@ -0,0 +1,391 @@
+/**
+ * @file view.h
+ *
+ * @brief Déclaration et définition de la classe template View (résultat de recherche sans copie)
+ *
+ * @author LEESTMANS Richard
+ * @author COUDERT Nicolas
+ */
+
+#ifndef CDAA_VIEW_H
+#define CDAA_VIEW_H
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
+
+/**
+ * Vue paresseuse sur des éléments d'une liste (Contacts, Todos, Interactions...).
+ * La vue ne copie aucun élément : elle référence la liste source et n'évalue ses filtres (where) qu'au parcours.
+ * Les filtres s'enchaînent sans rien parcourir : view.where(a).where(b) ne renvoie que les éléments qui
+ * vérifient a et b.
+ * Une vue reste valide tant que la liste source existe et n'est pas modifiée.
+ * \brief Vue paresseuse et filtrable sur une liste
+ * @tparam T Type des éléments
+ */
+template<typename T>
+class View
+{
+public:
+    using Cursor = std::function<const T*()>; /*!< Renvoie l'élément suivant de la source (nullptr à la fin) */
+    using Predicate = std::function<bool(const T&)>; /*!< Filtre sur un élément */
+
+private:
+    std::function<Cursor()> source; /*!< Crée un curseur au début de la source */
+    std::vector<Predicate> filters; /*!< Filtres à vérifier par chaque élément */
+
+    [[nodiscard]] bool accepts(const T& element) const;
+
+public:
+    /**
+     * Itérateur (constant) sur les éléments de la vue qui vérifient tous les filtres
+     */
+    class iterator
+    {
+    private:
+        const View* view; /*!< Vue parcourue */
+        Cursor cursor; /*!< Position dans la source */
+        const T* current; /*!< Élément courant (nullptr à la fin) */
+
+        void advance();
+
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+
+        iterator();
+        explicit iterator(const View* view);
+
+        reference operator*() const;
+        pointer operator->() const;
+        iterator& operator++();
+        bool operator==(const iterator& other) const;
+        bool operator!=(const iterator& other) const;
+    };
+
+    View();
+    explicit View(std::function<Cursor()> source);
+
+    [[nodiscard]] View where(Predicate predicate) const;
+    [[nodiscard]] View limit(std::size_t count) const;
+
+    [[nodiscard]] iterator begin() const;
+    [[nodiscard]] iterator end() const;
+    [[nodiscard]] std::size_t count() const;
+    [[nodiscard]] bool empty() const;
+
+    template<typename Container>
+    [[nodiscard]] static View of(const Container& container);
+    template<typename Ids, typename Resolver>
+    [[nodiscard]] static View byIds(Ids ids, Resolver resolve);
+    template<typename Range, typename Resolver>
+    [[nodiscard]] static View byRange(Range range, Resolver resolve);
+    template<typename Runs, typename Resolver, typename Less>
+    [[nodiscard]] static View merge(Runs runs, Resolver resolve, Less less);
+};
+
+/**
+ * Constructeur d'une vue vide
+ */
+template<typename T>
+View<T>::View() : View([]() { return Cursor([]() -> const T* { return nullptr; }); })
+{
+}
+
+/**
+ * Constructeur à partir d'une source
+ * @param source Fonction qui crée un curseur au début de la source
+ */
+template<typename T>
+View<T>::View(std::function<Cursor()> source) : source(std::move(source))
+{
+}
+
+/**
+ * Vérifie qu'un élément passe tous les filtres de la vue
+ * @param element Élément à vérifier
+ * @return Si l'élément fait partie de la vue
+ */
+template<typename T>
+bool View<T>::accepts(const T& element) const
+{
+    for(const auto& filter : this->filters)
+        if(!filter(element))
+            return false;
+    return true;
+}
+
+/**
+ * Renvoie une nouvelle vue restreinte aux éléments qui vérifient un filtre supplémentaire (rien n'est parcouru)
+ * @param predicate Filtre à ajouter
+ * @return Vue filtrée
+ */
+template<typename T>
+View<T> View<T>::where(Predicate predicate) const
+{
+    View<T> view = *this;
+    view.filters.push_back(std::move(predicate));
+    return view;
+}
+
+/**
+ * Renvoie une nouvelle vue restreinte aux count premiers éléments de celle-ci (le parcours s'arrête au dernier)
+ * @param count Nombre maximal d'éléments
+ * @return Vue limitée
+ */
+template<typename T>
+View<T> View<T>::limit(std::size_t count) const
+{
+    auto base = std::make_shared<const View<T>>(*this);
+    return View<T>([base, count]() {
+        std::size_t left = count;
+        iterator it = left ? base->begin() : base->end();
+        return Cursor([base, left, it]() mutable -> const T* {
+            if(left == 0 || it == base->end())
+                return nullptr;
+            const T* element = &*it;
+            if(--left)
+                ++it;
+            return element;
+        });
+    });
+}
+
+/**
+ * Itérateur sur le premier élément de la vue
+ * @return Itérateur début
+ */
+template<typename T>
+typename View<T>::iterator View<T>::begin() const
+{
+    return iterator(this);
+}
+
+/**
+ * Itérateur de fin de la vue
+ * @return Itérateur fin
+ */
+template<typename T>
+typename View<T>::iterator View<T>::end() const
+{
+    return iterator();
+}
+
+/**
+ * Compte les éléments de la vue (parcourt la source)
+ * @return Nombre d'éléments
+ */
+template<typename T>
+std::size_t View<T>::count() const
+{
+    std::size_t count = 0;
+    for(auto it = begin(); it != end(); ++it)
+        count++;
+    return count;
+}
+
+/**
+ * Indique si la vue est vide (s'arrête au premier élément trouvé)
+ * @return Si aucun élément ne vérifie les filtres
+ */
+template<typename T>
+bool View<T>::empty() const
+{
+    return begin() == end();
+}
+
+/**
+ * Vue sur tous les éléments d'un conteneur
+ * @param container Conteneur source (doit survivre à la vue)
+ * @return Vue sur le conteneur
+ */
+template<typename T>
+template<typename Container>
+View<T> View<T>::of(const Container& container)
+{
+    const Container* source = &container;
+    return View<T>([source]() {
+        auto it = std::begin(*source);
+        return Cursor([source, it]() mutable -> const T* {
+            if(it == std::end(*source))
+                return nullptr;
+            return &*it++;
+        });
+    });
+}
+
+/**
+ * Vue sur des éléments désignés par leur identifiant (poignée stable), résolus un à un au parcours.
+ * @param ids Fonction qui renvoie la liste des identifiants au début du parcours (const std::vector<int>*,
+ *            nullptr si aucun)
+ * @param resolve Fonction qui renvoie l'élément d'un identifiant (const T*, nullptr s'il n'existe plus)
+ * @return Vue sur les éléments, dans l'ordre des identifiants
+ */
+template<typename T>
+template<typename Ids, typename Resolver>
+View<T> View<T>::byIds(Ids ids, Resolver resolve)
+{
+    return View<T>([ids, resolve]() {
+        const std::vector<int>* handles = ids();
+        std::size_t next = 0;
+        return Cursor([handles, resolve, next]() mutable -> const T* {
+            while(handles && next < handles->size())
+                if(const T* element = resolve((*handles)[next++]))
+                    return element;
+            return nullptr;
+        });
+    });
+}
+
+/**
+ * Vue sur les éléments désignés par un intervalle d'index (poignées stables), résolus un à un au parcours.
+ * @param range Fonction qui renvoie l'intervalle [first; second[ au début du parcours (paire d'itérateurs)
+ * @param resolve Fonction qui renvoie l'élément d'une poignée de l'intervalle (const T*, nullptr s'il n'existe plus)
+ * @return Vue sur les éléments, dans l'ordre de l'intervalle
+ */
+template<typename T>
+template<typename Range, typename Resolver>
+View<T> View<T>::byRange(Range range, Resolver resolve)
+{
+    return View<T>([range, resolve]() {
+        auto bounds = range();
+        return Cursor([bounds, resolve]() mutable -> const T* {
+            while(bounds.first != bounds.second)
+                if(const T* element = resolve(*bounds.first++))
+                    return element;
+            return nullptr;
+        });
+    });
+}
+
+/**
+ * Vue sur la fusion de plusieurs intervalles triés (fusion k-aire paresseuse par un tas).
+ * Seule la tête de chaque intervalle est comparée : le premier élément est disponible après O(k) opérations, chaque
+ * élément suivant après O(log k), sans copier ni trier l'ensemble.
+ * @param runs Fonction qui renvoie les intervalles au début du parcours (std::vector de paires d'itérateurs, chaque
+ *             intervalle étant trié selon less)
+ * @param resolve Fonction qui renvoie l'élément d'une poignée (const T*, nullptr s'il n'existe plus)
+ * @param less Ordre des poignées (celui des intervalles)
+ * @return Vue sur les éléments de tous les intervalles, dans l'ordre less
+ */
+template<typename T>
+template<typename Runs, typename Resolver, typename Less>
+View<T> View<T>::merge(Runs runs, Resolver resolve, Less less)
+{
+    return View<T>([runs, resolve, less]() {
+        auto heap = runs();
+        using Run = typename decltype(heap)::value_type;
+
+        // Min-heap on the head of each run
+        auto later = [less](const Run& a, const Run& b) { return less(*b.first, *a.first); };
+        heap.erase(std::remove_if(heap.begin(), heap.end(), [](const Run& r) { return r.first == r.second; }),
+                   heap.end());
+        std::make_heap(heap.begin(), heap.end(), later);
+
+        return Cursor([heap, resolve, later]() mutable -> const T* {
+            while(!heap.empty()) {
+                std::pop_heap(heap.begin(), heap.end(), later);
+                Run& run = heap.back();
+                const T* element = resolve(*run.first++);
+                if(run.first == run.second)
+                    heap.pop_back();
+                else
+                    std::push_heap(heap.begin(), heap.end(), later);
+                if(element)
+                    return element;
+            }
+            return nullptr;
+        });
+    });
+}
+
+/**
+ * Itérateur de fin
+ */
+template<typename T>
+View<T>::iterator::iterator() : view(nullptr), current(nullptr)
+{
+}
+
+/**
+ * Itérateur sur le premier élément d'une vue
+ * @param view Vue à parcourir
+ */
+template<typename T>
+View<T>::iterator::iterator(const View* view) : view(view), cursor(view->source()), current(nullptr)
+{
+    advance();
+}
+
+/**
+ * Avance jusqu'au prochain élément qui vérifie les filtres de la vue
+ */
+template<typename T>
+void View<T>::iterator::advance()
+{
+    do
+        this->current = this->cursor();
+    while(this->current && !this->view->accepts(*this->current));
+}
+
+/**
+ * Élément courant
+ * @return Référence constante sur l'élément
+ */
+template<typename T>
+typename View<T>::iterator::reference View<T>::iterator::operator*() const
+{
+    return *this->current;
+}
+
+/**
+ * Accès aux membres de l'élément courant
+ * @return Pointeur constant sur l'élément
+ */
+template<typename T>
+typename View<T>::iterator::pointer View<T>::iterator::operator->() const
+{
+    return this->current;
+}
+
+/**
+ * Passe à l'élément suivant
+ * @return Itérateur avancé
+ */
+template<typename T>
+typename View<T>::iterator& View<T>::iterator::operator++()
+{
+    advance();
+    return *this;
+}
+
+/**
+ * Deux itérateurs sont égaux s'ils pointent sur le même élément (ou sont tous les deux à la fin)
+ * @param other Itérateur à comparer
+ * @return S'ils sont égaux
+ */
+template<typename T>
+bool View<T>::iterator::operator==(const iterator& other) const
+{
+    return this->current == other.current;
+}
+
+/**
+ * Inverse de l'opérateur ==
+ * @param other Itérateur à comparer
+ * @return S'ils sont différents
+ */
+template<typename T>
+bool View<T>::iterator::operator!=(const iterator& other) const
+{
+    return !(*this == other);
+}
+
+#endif // CDAA_VIEW_H